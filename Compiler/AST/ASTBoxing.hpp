@@ -20,6 +20,9 @@ class ASTBoxing : public ASTUnaryMFForwarding {
 public:
     ASTBoxing(std::shared_ptr<ASTExpr> expr, const SourcePosition &p, const Type &exprType);
     Type analyse(ExpressionAnalyser *) final { return expressionType(); }
+
+    /// The expression whose value is boxed.
+    const std::shared_ptr<ASTExpr>& expr() const { return expr_; }
     
 protected:
     /// Gets a pointer to the value area of box and bit-casts it to the type matching the ASTExpr::expressionType()
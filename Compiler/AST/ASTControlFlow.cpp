@@ -8,16 +8,24 @@
 
 #include "ASTControlFlow.hpp"
 #include "AST/ASTNode.hpp"
+#include "ASTBinaryOperator.hpp"
+#include "ASTBoxing.hpp"
+#include "ASTInitialization.hpp"
+#include "ASTLiterals.hpp"
 #include "ASTMethod.hpp"
 #include "ASTVariables.hpp"
 #include "Analysis/FunctionAnalyser.hpp"
 #include "Compiler.hpp"
 #include "Emojis.h"
 #include "MemoryFlowAnalysis/MFFunctionAnalyser.hpp"
+#include "Package/Package.hpp"
+#include "Parsing/AbstractParser.hpp"
+#include "Parsing/OperatorHelper.hpp"
 #include "Scoping/SemanticScoper.hpp"
 #include "Types/Class.hpp"
 #include "Types/Protocol.hpp"
 #include "Types/TypeExpectation.hpp"
+#include <algorithm>
 
 namespace EmojicodeCompiler {
 
@@ -132,13 +140,100 @@ void ASTErrorHandler::analyseMemoryFlow(MFFunctionAnalyser *analyser) {
 void ASTForIn::analyse(FunctionAnalyser *analyser) {
     analyser->scoper().pushScope();
 
+    auto iterateeVar = U"iteratee" + varName_;
+    iterateeInit_ = std::make_unique<ASTConstantVariable>(iterateeVar, std::move(iteratee_), position());
+    iterateeInit_->analyse(analyser);
+    auto type = analyser->scoper().currentScope().getLocalVariable(iterateeVar).type();
+
     ASTBlock newBlock(position());
+    if (iteratesByIndex(analyser, type)) {
+        lowerToIndexLoop(&newBlock, iterateeVar);
+    }
+    else {
+        lowerToIteratorLoop(&newBlock, iterateeVar);
+    }
+    block_ = std::move(newBlock);
+    block_.analyse(analyser);
+    block_.popScope(analyser);
+}
 
+bool ASTForIn::iteratesByIndex(FunctionAnalyser *analyser, const Type &type) const {
+    if (type.type() != TypeType::ValueType && type.type() != TypeType::Class) {
+        return false;
+    }
+    auto getIterator = type.typeDefinition()->methods().lookup(std::u32string(1, E_DANGO), Mood::Imperative, {},
+                                                               type, analyser->typeContext(),
+                                                               analyser->semanticAnalyser());
+    if (getIterator == nullptr) {
+        return false;
+    }
+    if (type.type() == TypeType::Class && !type.klass()->final() && !getIterator->final()) {
+        return false;
+    }
+    auto randomAccess = analyser->package()->getRawType(TypeIdentifier(U"🐽", kDefaultNamespace, position()));
+    auto &protocols = type.typeDefinition()->protocols();
+    if (std::none_of(protocols.begin(), protocols.end(), [&randomAccess](const ProtocolConformance &conformance) {
+        return conformance.type->type().typeDefinition() == randomAccess.typeDefinition();
+    })) {
+        return false;
+    }
+    auto indexIterator = analyser->package()->getRawType(TypeIdentifier(U"🌳", kDefaultNamespace, position()));
+    auto iteratorType = getIterator->returnType()->type();
+    return iteratorType.type() == TypeType::Class && iteratorType.klass() == indexIterator.klass() &&
+           returnsIteratorOverThis(getIterator);
+}
+
+bool ASTForIn::returnsIteratorOverThis(Function *getIterator) {
+    // Single statement methods are inline, so their body is available even if they were imported from a package.
+    if (getIterator->ast() == nullptr || getIterator->ast()->stmtsSize() != 1) {
+        return false;
+    }
+    auto returnStmt = dynamic_cast<ASTReturn *>(getIterator->ast()->stmt(0));
+    if (returnStmt == nullptr) {
+        return false;
+    }
+    auto init = dynamic_cast<ASTInitialization *>(returnStmt->value().get());
+    if (init == nullptr || init->args().args().size() != 1) {
+        return false;
+    }
+    auto arg = init->args().args().front().get();
+    while (auto boxing = dynamic_cast<ASTBoxing *>(arg)) {
+        arg = boxing->expr().get();
+    }
+    return dynamic_cast<ASTThis *>(arg) != nullptr;
+}
+
+void ASTForIn::lowerToIndexLoop(ASTBlock *block, const std::u32string &iterateeVar) {
+    auto indexVar = U"index" + varName_;
+    block->appendNode(std::make_unique<ASTVariableDeclareAndAssign>(
+            indexVar, std::make_shared<ASTNumberLiteral>(static_cast<int64_t>(0), U"0", position()), position()));
+
+    ASTArguments getArgs(position());
+    getArgs.addArguments(std::make_shared<ASTGetVariable>(indexVar, position()));
+    auto get = std::make_shared<ASTMethod>(std::u32string(1, 0x1F43D),
+                                           std::make_shared<ASTGetVariable>(iterateeVar, position()),
+                                           getArgs, position());
+    block_.prependNode(std::make_unique<ASTOperatorAssignment>(
+            indexVar, std::make_shared<ASTNumberLiteral>(static_cast<int64_t>(1), U"1", position()), position(),
+            OperatorType::Plus));
+    block_.prependNode(std::make_unique<ASTConstantVariable>(varName_, get, position()));
+
+    auto count = std::make_shared<ASTMethod>(std::u32string(1, 0x1F4CF),
+                                             std::make_shared<ASTGetVariable>(iterateeVar, position()),
+                                             ASTArguments(position(), Mood::Interogative), position());
+    auto condition = std::make_shared<ASTBinaryOperator>(OperatorType::Less,
+                                                         std::make_shared<ASTGetVariable>(indexVar, position()),
+                                                         count, position());
+    block->appendNode(std::make_unique<ASTRepeatWhile>(condition, std::move(block_), position()));
+}
+
+void ASTForIn::lowerToIteratorLoop(ASTBlock *block, const std::u32string &iterateeVar) {
     auto iteratorVar = U"iterator" + varName_;
 
-    auto getIterator = std::make_shared<ASTMethod>(std::u32string(1, E_DANGO), std::move(iteratee_),
+    auto getIterator = std::make_shared<ASTMethod>(std::u32string(1, E_DANGO),
+                                                   std::make_shared<ASTGetVariable>(iterateeVar, position()),
                                                    ASTArguments(position()), position());
-    newBlock.appendNode(std::make_unique<ASTConstantVariable>(iteratorVar, getIterator, position()));
+    block->appendNode(std::make_unique<ASTConstantVariable>(iteratorVar, getIterator, position()));
     auto getNext = std::make_shared<ASTMethod>(std::u32string(1, 0x1F53D),
                                                std::make_shared<ASTGetVariable>(iteratorVar, position()),
                                                ASTArguments(position()), position());
@@ -147,13 +242,11 @@ void ASTForIn::analyse(FunctionAnalyser *analyser) {
     auto hasNext = std::make_shared<ASTMethod>(std::u32string(1, 0x1F53D),
                                                std::make_shared<ASTGetVariable>(iteratorVar, position()),
                                                ASTArguments(position(), Mood::Interogative), position());
-    newBlock.appendNode(std::make_unique<ASTRepeatWhile>(hasNext, std::move(block_), position()));
-    block_ = std::move(newBlock);
-    block_.analyse(analyser);
-    block_.popScope(analyser);
+    block->appendNode(std::make_unique<ASTRepeatWhile>(hasNext, std::move(block_), position()));
 }
 
 void ASTForIn::analyseMemoryFlow(MFFunctionAnalyser *analyser) {
+    iterateeInit_->analyseMemoryFlow(analyser);
     block_.analyseMemoryFlow(analyser);
     analyser->popScope(&block_);
 }
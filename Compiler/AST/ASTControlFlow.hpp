@@ -76,6 +76,19 @@ private:
     std::shared_ptr<ASTExpr> iteratee_;
     ASTBlock block_;
     std::u32string varName_;
+    /// Stores the iteratee in a variable so that the loop can access it repeatedly.
+    std::unique_ptr<ASTStatement> iterateeInit_;
+
+    /// Returns true if iterating over an instance of @c type with its 🍡 iterator is equivalent to retrieving the
+    /// elements by index with 🐽, i.e. if @c type conforms to 🐽, its 🍡 returns a 🌳 over 👇 and cannot be
+    /// overridden by a subclass.
+    bool iteratesByIndex(FunctionAnalyser *analyser, const Type &type) const;
+    /// Returns true if @c getIterator consists of a single statement returning a 🌳 initialized with 👇.
+    static bool returnsIteratorOverThis(Function *getIterator);
+    /// Transforms the loop into a loop that retrieves the elements of the iteratee with 🐽 until 📏 is reached.
+    void lowerToIndexLoop(ASTBlock *block, const std::u32string &iterateeVar);
+    /// Transforms the loop into a loop that calls 🔽 on the iterator returned by 🍡 until 🔽❓ returns 👎.
+    void lowerToIteratorLoop(ASTBlock *block, const std::u32string &iterateeVar);
 };
 
 class ASTErrorHandler final : public ASTStatement, public ErrorHandling {
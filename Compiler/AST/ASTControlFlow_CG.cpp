@@ -127,6 +127,8 @@ void ASTErrorHandler::generate(FunctionCodeGenerator *fg) const {
 }
 
 void ASTForIn::generate(FunctionCodeGenerator *fg) const {
+    iterateeInit_->generate(fg);
+    fg->releaseTemporaryObjects();
     block_.generate(fg);
 }
 
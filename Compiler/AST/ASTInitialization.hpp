@@ -42,6 +42,7 @@ public:
     void setDestination(llvm::Value *dest) { vtDestination_ = dest; }
     /// Returns the type of type which is initialized.
     InitType initType() { return initType_; }
+    const ASTArguments& args() const { return args_; }
 
     void allocateOnStack() override;
 
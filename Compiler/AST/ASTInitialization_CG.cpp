@@ -88,7 +88,7 @@ Value* ASTInitialization::initObject(FunctionCodeGenerator *fg, const ASTArgumen
 Value* ASTInitialization::generateMemoryAllocation(FunctionCodeGenerator *fg) const {
     auto size = fg->builder().CreateAdd(args_.args()[0]->generate(fg),
                                         fg->sizeOf(llvm::Type::getInt8PtrTy(fg->ctx())));
-    return fg->builder().CreateCall(fg->generator()->runTime().alloc(), size, "alloc");
+    return fg->builder().CreateCall(fg->generator()->runTime().allocMemory(), size, "alloc");
 }
 
 }  // namespace EmojicodeCompiler
@@ -10,6 +10,7 @@
 #include "Generation/FunctionCodeGenerator.hpp"
 #include "Generation/RunTimeHelper.hpp"
 #include "Generation/CallCodeGenerator.hpp"
+#include "ASTBoxing.hpp"
 #include "ASTInitialization.hpp"
 #include "ASTLiterals.hpp"
 #include "Analysis/FunctionAnalyser.hpp"
@@ -23,6 +24,7 @@
 #include "Types/ValueType.hpp"
 #include "Types/CommonTypeFinder.hpp"
 #include "Types/TypeExpectation.hpp"
+#include <algorithm>
 
 namespace EmojicodeCompiler {
 
@@ -117,6 +119,17 @@ Type ASTCollectionLiteral::analyse(ExpressionAnalyser *analyser) {
     return Type::listLiteral(finder_->getCommonType());
 }
 
+/// Returns true if @c expr is a string, number or boolean literal, which may have been boxed.
+static bool isConstant(const ASTExpr *expr) {
+    if (auto boxing = dynamic_cast<const ASTBoxing *>(expr)) {
+        return isConstant(boxing->expr().get());
+    }
+    return dynamic_cast<const ASTStringLiteral *>(expr) != nullptr ||
+            dynamic_cast<const ASTNumberLiteral *>(expr) != nullptr ||
+            dynamic_cast<const ASTBooleanTrue *>(expr) != nullptr ||
+            dynamic_cast<const ASTBooleanFalse *>(expr) != nullptr;
+}
+
 Type ASTCollectionLiteral::complyPairs(ExpressionAnalyser *analyser, const TypeExpectation &expectation) {
     if (expectation.type() == TypeType::ValueType && expectation.typeDefinition()->canInitFrom(expressionType())) {
         type_ = expectation.copyType();
@@ -136,6 +149,8 @@ Type ASTCollectionLiteral::complyPairs(ExpressionAnalyser *analyser, const TypeE
         }
         analyser->comply(TypeExpectation(elementType), &(*it));
     }
+    cached_ = type_.typeDefinition() == analyser->compiler()->sDictionary &&
+            std::all_of(values_.begin(), values_.end(), [](auto &value) { return isConstant(value.get()); });
     initializer_ = type_.typeDefinition()->inits().lookup(U"🍪", Mood::Imperative,
                                                           { analyser->compiler()->sMemory->type(), analyser->compiler()->sMemory->type(), analyser->integer() }, type_, analyser->typeContext(),
                                                           analyser->semanticAnalyser());
@@ -188,12 +203,49 @@ Type ASTInterpolationLiteral::analyse(ExpressionAnalyser *analyser) {
     toString_ = magnet.typeDefinition()->methods().lookup(U"🔡", Mood::Imperative, {}, magnet,
                                                           analyser->typeContext(), analyser->semanticAnalyser());
 
+    auto string = Type(analyser->compiler()->sString);
+    count_ = string.typeDefinition()->methods().lookup(U"📐", Mood::Imperative, {}, string,
+                                                       analyser->typeContext(), analyser->semanticAnalyser());
+
     for (auto &value : values_) {
-        analyser->expectType(magnet, &value);
+        auto type = analyser->analyse(value);
+        auto appender = directAppender(analyser, type, sb);
+        appenders_.emplace_back(appender);
+        if (appender != nullptr) {
+            analyser->comply(TypeExpectation(type), &value);
+            continue;
+        }
+        auto resultType = analyser->comply(TypeExpectation(magnet), &value);
+        if (!resultType.compatibleTo(magnet, analyser->typeContext())) {
+            throw CompilerError(value->position(), resultType.toString(analyser->typeContext()),
+                                " is not compatible to ", magnet.toString(analyser->typeContext()), ".");
+        }
     }
     return analyser->compiler()->sString->type();
 }
 
+Function* ASTInterpolationLiteral::directAppender(ExpressionAnalyser *analyser, const Type &type, const Type &sb) {
+    if (type.type() != TypeType::ValueType && type.type() != TypeType::Class) {
+        return nullptr;
+    }
+    auto compiler = analyser->compiler();
+    if (type.typeDefinition() == compiler->sString) {
+        return append_;
+    }
+    std::u32string name;
+    if (type.typeDefinition() == compiler->sInteger) {
+        name = U"🐻🔸🔢";
+    }
+    else if (type.typeDefinition() == compiler->sReal) {
+        name = U"🐻🔸💯";
+    }
+    else {
+        return nullptr;
+    }
+    return sb.typeDefinition()->methods().lookup(name, Mood::Imperative, { type }, sb,
+                                                 analyser->typeContext(), analyser->semanticAnalyser());
+}
+
 void ASTInterpolationLiteral::analyseMemoryFlow(MFFunctionAnalyser *analyser, MFFlowCategory type) {
     for (auto &valueNode : values_) {
         valueNode->analyseMemoryFlow(analyser, MFFlowCategory::Borrowing);
@@ -13,6 +13,11 @@
 #include <utility>
 #include <llvm/IR/Type.h>
 
+namespace llvm {
+class Function;
+class GlobalVariable;
+}  // namespace llvm
+
 namespace EmojicodeCompiler {
 
 class FunctionAnalyser;
@@ -112,9 +117,17 @@ protected:
     Type type_ = Type::noReturn();
     Initializer *initializer_ = nullptr;
     Value *init(FunctionCodeGenerator *fg, std::vector<llvm::Value *> args) const;
+    void initialize(FunctionCodeGenerator *fg, std::vector<llvm::Value *> args, Value *destination) const;
     bool pairs_ = false;
+    /// True if this is a 🍯 literal whose keys and values are all literals. Such a literal is only built once per
+    /// thread and then copied.
+    bool cached_ = false;
     std::unique_ptr<CommonTypeFinder> finder_;
     Value* generatePairs(FunctionCodeGenerator *fg) const;
+    void initializePairs(FunctionCodeGenerator *fg, Value *destination) const;
+    Value* generateCachedPairs(FunctionCodeGenerator *fg) const;
+    /// Builds a function that releases the dictionary in the calling thread's instance of the thread-local @c cache.
+    llvm::Function* buildCacheRelease(FunctionCodeGenerator *fg, llvm::GlobalVariable *cache) const;
     Type complyPairs(ExpressionAnalyser *analyser, const TypeExpectation &expectation);
 };
 
@@ -136,7 +149,17 @@ private:
     Function *append_ = nullptr;
     Function *get_ = nullptr;
     Function *toString_ = nullptr;
-    void append(FunctionCodeGenerator *fg, llvm::Value *value, llvm::Value *builder) const;
+    Function *count_ = nullptr;
+    /// The 🔠 method that appends the value at the same index in values_ without converting it to a 🔡 first, or
+    /// nullptr if the value is boxed and converted with toString_.
+    std::vector<Function *> appenders_;
+
+    /// Returns the 🔠 method that can append a value of @c type directly or nullptr if there is none.
+    Function* directAppender(ExpressionAnalyser *analyser, const Type &type, const Type &sb);
+    /// Returns the number of bytes the value at @c index in values_, which was generated as @c value, is expected to
+    /// append to the builder.
+    llvm::Value* estimateLength(FunctionCodeGenerator *fg, size_t index, llvm::Value *value) const;
+    void append(FunctionCodeGenerator *fg, llvm::Value *value, llvm::Value *builder, Function *appender) const;
     void append(FunctionCodeGenerator *fg, const std::u32string &literal, llvm::Value *builder) const;
 };
 
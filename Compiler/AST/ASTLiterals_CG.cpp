@@ -16,6 +16,9 @@
 #include "Generation/FunctionCodeGenerator.hpp"
 #include "Generation/StringPool.hpp"
 #include "Types/Class.hpp"
+#include "Types/TypeContext.hpp"
+#include "Types/ValueType.hpp"
+#include "Utils/StringUtils.hpp"
 
 namespace EmojicodeCompiler {
 
@@ -62,15 +65,20 @@ Value* ASTNoValue::generate(FunctionCodeGenerator *fg) const {
 }
 
 Value* ASTCollectionLiteral::init(FunctionCodeGenerator *fg, std::vector<llvm::Value*> args) const {
-    auto td = TypeDescriptionGenerator(fg, TypeDescriptionUser::ValueTypeOrValue).generate(type_.genericArguments());
     auto value = fg->createEntryAlloca(fg->typeHelper().llvmTypeFor(type_));
-    args.emplace_back(td);
-    CallCodeGenerator(fg, CallType::StaticDispatch).generate(value, type_, ASTArguments(position()),
-                                                             initializer_, nullptr, args);
+    initialize(fg, std::move(args), value);
     handleResult(fg, nullptr, value);
     return fg->builder().CreateLoad(value);
 }
 
+void ASTCollectionLiteral::initialize(FunctionCodeGenerator *fg, std::vector<llvm::Value *> args,
+                                      Value *destination) const {
+    auto td = TypeDescriptionGenerator(fg, TypeDescriptionUser::ValueTypeOrValue).generate(type_.genericArguments());
+    args.emplace_back(td);
+    CallCodeGenerator(fg, CallType::StaticDispatch).generate(destination, type_, ASTArguments(position()),
+                                                             initializer_, nullptr, args);
+}
+
 std::pair<llvm::Value *, llvm::Value *> EmojicodeCompiler::ASTCollectionLiteral::prepareValueArray(FunctionCodeGenerator *fg, llvm::Type *type, size_t count,
                                                                                                    const char *name) const {
     auto arrayType = llvm::ArrayType::get(type, count);
@@ -98,6 +106,61 @@ Value* ASTCollectionLiteral::generate(FunctionCodeGenerator *fg) const {
 }
 
 Value *ASTCollectionLiteral::generatePairs(FunctionCodeGenerator *fg) const {
+    if (cached_) {
+        return generateCachedPairs(fg);
+    }
+    auto value = fg->createEntryAlloca(fg->typeHelper().llvmTypeFor(type_));
+    initializePairs(fg, value);
+    handleResult(fg, nullptr, value);
+    return fg->builder().CreateLoad(value);
+}
+
+Value *ASTCollectionLiteral::generateCachedPairs(FunctionCodeGenerator *fg) const {
+    auto type = fg->typeHelper().llvmTypeFor(type_);
+    // Each thread builds its own copy, so the first evaluation needs no synchronisation between threads. The copy is
+    // released when the thread exits.
+    auto cache = new llvm::GlobalVariable(*fg->generator()->module(), type, false,
+                                          llvm::GlobalValue::LinkageTypes::PrivateLinkage,
+                                          llvm::Constant::getNullValue(type), "dictionaryLiteral", nullptr,
+                                          llvm::GlobalValue::GeneralDynamicTLSModel);
+    auto built = new llvm::GlobalVariable(*fg->generator()->module(), fg->builder().getInt1Ty(), false,
+                                          llvm::GlobalValue::LinkageTypes::PrivateLinkage,
+                                          llvm::ConstantInt::getFalse(fg->ctx()), "dictionaryLiteralBuilt", nullptr,
+                                          llvm::GlobalValue::GeneralDynamicTLSModel);
+
+    auto function = fg->builder().GetInsertBlock()->getParent();
+    auto buildBlock = llvm::BasicBlock::Create(fg->ctx(), "buildLiteral", function);
+    auto copyBlock = llvm::BasicBlock::Create(fg->ctx(), "copyLiteral", function);
+    fg->builder().CreateCondBr(fg->builder().CreateLoad(built), copyBlock, buildBlock);
+
+    fg->builder().SetInsertPoint(buildBlock);
+    initializePairs(fg, cache);
+    fg->builder().CreateStore(llvm::ConstantInt::getTrue(fg->ctx()), built);
+    fg->builder().CreateCall(fg->generator()->runTime().releaseAtThreadExit(), buildCacheRelease(fg, cache));
+    fg->builder().CreateBr(copyBlock);
+
+    fg->builder().SetInsertPoint(copyBlock);
+    Value *value = fg->builder().CreateLoad(cache);
+    fg->retain(fg->isManagedByReference(type_) ? cache : value, type_);
+    return handleResult(fg, value);
+}
+
+llvm::Function* ASTCollectionLiteral::buildCacheRelease(FunctionCodeGenerator *fg, llvm::GlobalVariable *cache) const {
+    auto function = llvm::Function::Create(llvm::FunctionType::get(llvm::Type::getVoidTy(fg->ctx()), false),
+                                           llvm::GlobalValue::LinkageTypes::PrivateLinkage,
+                                           "dictionaryLiteralRelease", fg->generator()->module());
+    FunctionCodeGenerator releaseFg(function, fg->generator(), std::make_unique<TypeContext>(type_));
+    releaseFg.createEntry();
+    Value *value = cache;
+    if (!releaseFg.isManagedByReference(type_)) {
+        value = releaseFg.builder().CreateLoad(cache);
+    }
+    releaseFg.release(value, type_);
+    releaseFg.builder().CreateRetVoid();
+    return function;
+}
+
+void ASTCollectionLiteral::initializePairs(FunctionCodeGenerator *fg, Value *destination) const {
     llvm::Value *keys, *values, *currentKey, *currentValue;
     auto string = fg->typeHelper().llvmTypeFor(Type(fg->compiler()->sString));
     std::tie(currentKey, keys) = prepareValueArray(fg, string, values_.size() / 2, "keys");
@@ -109,27 +172,49 @@ Value *ASTCollectionLiteral::generatePairs(FunctionCodeGenerator *fg) const {
         currentKey = fg->builder().CreateConstInBoundsGEP1_32(string, currentKey, 1);
         currentValue = fg->builder().CreateConstInBoundsGEP1_32(fg->typeHelper().box(), currentValue, 1);
     }
-    return init(fg, {fg->builder().CreateBitCast(keys, fg->builder().getInt8PtrTy()),
-                     fg->builder().CreateBitCast(values, fg->builder().getInt8PtrTy()), fg->int64(values_.size() / 2)});
+    initialize(fg, {fg->builder().CreateBitCast(keys, fg->builder().getInt8PtrTy()),
+                    fg->builder().CreateBitCast(values, fg->builder().getInt8PtrTy()), fg->int64(values_.size() / 2)},
+               destination);
 }
 
 
 Value* ASTInterpolationLiteral::generate(FunctionCodeGenerator *fg) const {
-    int64_t length = 0;
+    int64_t constantLength = 0;
     for (auto &literal : literals_) {
-        length += literal.size() + 6;
+        constantLength += utf8(literal).size();
+    }
+
+    // The values are evaluated first so that the builder can be created with the capacity needed for the result.
+    auto stringType = Type(fg->compiler()->sString);
+    std::vector<llvm::Value *> values;
+    llvm::Value *length = fg->int64(constantLength);
+    for (size_t i = 0; i < values_.size(); i++) {
+        auto value = values_[i]->generate(fg);
+        if (appenders_[i] == nullptr) {
+            value = CallCodeGenerator(fg, CallType::DynamicProtocolDispatch)
+                    .generate(value, values_[i]->expressionType(), ASTArguments(position()), toString_, nullptr);
+        }
+        values.emplace_back(value);
+        length = fg->builder().CreateAdd(length, estimateLength(fg, i, value));
     }
+
     auto type = init_->owner()->type();
-    auto lengthNode = std::make_shared<ASTNumberLiteral>(length, U"", position());
-    auto builder = ASTInitialization::initObject(fg, ASTArguments(position(), {lengthNode}), init_, type, nullptr, true,
-                                                 nullptr);
+    auto llvmType = llvm::dyn_cast<llvm::PointerType>(fg->typeHelper().llvmTypeFor(type));
+    auto builder = fg->stackAlloc(llvmType);
+    fg->builder().CreateStore(type.klass()->classInfo(), fg->buildGetClassInfoPtrFromObject(builder));
+    CallCodeGenerator(fg, CallType::StaticDispatch).generate(builder, type, ASTArguments(position()), init_, nullptr,
+                                                             { length });
 
     auto literalsIt = literals_.begin();
     append(fg, *literalsIt++, builder);
-    for (auto &value : values_) {
-        auto str = CallCodeGenerator(fg, CallType::DynamicProtocolDispatch).generate(value->generate(fg), value->expressionType(),
-                                                                 ASTArguments(position()), toString_, nullptr);
-        append(fg, str, builder);
+    for (size_t i = 0; i < values_.size(); i++) {
+        if (appenders_[i] == nullptr) {
+            append(fg, values[i], builder, append_);
+            fg->release(values[i], stringType);
+        }
+        else {
+            append(fg, values[i], builder, appenders_[i]);
+        }
         append(fg, *literalsIt++, builder);
     }
 
@@ -139,11 +224,26 @@ Value* ASTInterpolationLiteral::generate(FunctionCodeGenerator *fg) const {
     return handleResult(fg, str);
 }
 
-void
-ASTInterpolationLiteral::append(FunctionCodeGenerator *fg, llvm::Value *value, llvm::Value *builder) const {
+llvm::Value* ASTInterpolationLiteral::estimateLength(FunctionCodeGenerator *fg, size_t index,
+                                                     llvm::Value *value) const {
+    auto compiler = fg->compiler();
+    auto type = values_[index]->expressionType();
+    // Numbers are appended by 🐻🔸🔢 and 🐻🔸💯, which reserve the space they need themselves. These are the most
+    // characters appended for any 🔢 and for a 💯 of a magnitude below 10^19.
+    if (appenders_[index] != nullptr && type.typeDefinition() == compiler->sInteger) {
+        return fg->int64(20);
+    }
+    if (appenders_[index] != nullptr && type.typeDefinition() == compiler->sReal) {
+        return fg->int64(27);
+    }
+    return CallCodeGenerator(fg, CallType::DynamicDispatch).generate(value, Type(compiler->sString),
+                                                                     ASTArguments(position()), count_, nullptr);
+}
+
+void ASTInterpolationLiteral::append(FunctionCodeGenerator *fg, llvm::Value *value, llvm::Value *builder,
+                                     Function *appender) const {
     CallCodeGenerator(fg, CallType::StaticDispatch).generate(builder, init_->owner()->type(), ASTArguments(position()),
-                                                             append_, nullptr,
-                                                             {value});
+                                                             appender, nullptr, {value});
 }
 
 void
@@ -151,7 +251,7 @@ ASTInterpolationLiteral::append(FunctionCodeGenerator *fg, const std::u32string
     if (literal.empty()) {
         return;
     }
-    append(fg, fg->generator()->stringPool().pool(literal), builder);
+    append(fg, fg->generator()->stringPool().pool(literal), builder, append_);
 }
 
 }  // namespace EmojicodeCompiler
@@ -170,6 +170,8 @@ void ASTMethodable::prepareBuiltIns(Compiler *c) {
         {{c->sInteger, E_NEGATIVE_SQUARED_CROSS_MARK}, BuiltInType::IntegerNot},
         {{c->sInteger, E_BATTERY}, BuiltInType::IntegerInverse},
         {{c->sInteger, 0x1f4a7}, BuiltInType::IntegerToByte},
+        {{c->sInteger, 0x1F9EE}, BuiltInType::IntegerPopCount},
+        {{c->sInteger, 0x1F43E}, BuiltInType::IntegerTrailingZeros},
         {{c->sByte, E_NEGATIVE_SQUARED_CROSS_MARK}, BuiltInType::IntegerNot},
         {{c->sByte, E_BATTERY}, BuiltInType::IntegerInverse},
         {{c->sByte, 0x1f522}, BuiltInType::ByteToInteger},
@@ -185,6 +187,7 @@ void ASTMethodable::prepareBuiltIns(Compiler *c) {
         {{c->sReal, 0x1f522}, BuiltInType::DoubleToInteger},
         {{c->sMemory, E_RECYCLING_SYMBOL}, BuiltInType::Release},
         {{c->sMemory, 0x1F69C}, BuiltInType::MemoryMove},
+        {{c->sMemory, 0x1F4CB}, BuiltInType::MemoryCopyValues},
         {{c->sMemory, 0x270D}, BuiltInType::MemorySet},
         {{c->sMemory, 0x1F43D}, BuiltInType::Load},
     };
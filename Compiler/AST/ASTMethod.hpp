@@ -39,8 +39,9 @@ protected:
         IntegerMultiply, IntegerAdd, IntegerSubstract, IntegerDivide, IntegerGreater, IntegerGreaterOrEqual,
         IntegerLess, IntegerLessOrEqual, IntegerLeftShift, IntegerRightShift, IntegerOr, IntegerAnd, IntegerXor,
         IntegerRemainder, IntegerToDouble, IntegerNot, IntegerInverse, IntegerToByte, ByteToInteger,
+        IntegerPopCount, IntegerTrailingZeros,
         BooleanAnd, BooleanOr, BooleanNegate,
-        Equal, Store, Load, Release, MemoryMove, MemorySet, IsNoValueLeft, IsNoValueRight, Multiprotocol,
+        Equal, Store, Load, Release, MemoryMove, MemoryCopyValues, MemorySet, IsNoValueLeft, IsNoValueRight, Multiprotocol,
     };
 
     BuiltInType builtIn_ = BuiltInType::None;
@@ -34,6 +34,10 @@ Value* ASTMethod::generate(FunctionCodeGenerator *fg) const {
                 return fg->builder().CreateTrunc(v, llvm::Type::getInt8Ty(fg->ctx()));
             case BuiltInType::ByteToInteger:
                 return fg->builder().CreateSExt(v, llvm::Type::getInt64Ty(fg->ctx()));
+            case BuiltInType::IntegerPopCount:
+                return callIntrinsic(fg, llvm::Intrinsic::ID::ctpop, v);
+            case BuiltInType::IntegerTrailingZeros:
+                return callIntrinsic(fg, llvm::Intrinsic::ID::cttz, {v, llvm::ConstantInt::getFalse(fg->ctx())});
             case BuiltInType::DoubleInverse:
                 return fg->builder().CreateFNeg(v);
             case BuiltInType::Power:
@@ -90,6 +94,17 @@ Value* ASTMethod::generate(FunctionCodeGenerator *fg) const {
                                             args_.args()[3]->generate(fg));
                 return nullptr;
             }
+            case BuiltInType::MemoryCopyValues: {
+                auto type = args_.genericArguments().front()->type();
+                auto destination = buildMemoryAddress(fg, v, args_.args()[0]->generate(fg), type);
+                auto source = buildMemoryAddress(fg, args_.args()[1]->generate(fg), args_.args()[2]->generate(fg),
+                                                 type);
+                auto count = args_.args()[3]->generate(fg);
+                auto size = fg->builder().CreateMul(count, fg->sizeOf(fg->typeHelper().llvmTypeFor(type)));
+                fg->builder().CreateMemCpy(destination, 0, source, 0, size);
+                fg->retainValues(destination, count, type);
+                return nullptr;
+            }
             case BuiltInType::MemorySet: {
                 fg->builder().CreateMemSet(buildAddOffsetAddress(fg, v, args_.args()[1]->generate(fg)),
                                            args_.args()[0]->generate(fg), args_.args()[2]->generate(fg), 0);
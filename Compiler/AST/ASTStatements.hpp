@@ -74,6 +74,8 @@ public:
     size_t endIndex() const { return endIndex_; }
 
     size_t stmtsSize() const { return stmts_.size(); }
+    /// Returns the statement at @c index, which must be less than stmtsSize().
+    ASTStatement* stmt(size_t index) const { return stmts_[index].get(); }
     
 private:
     std::vector<std::unique_ptr<ASTStatement>> stmts_;
@@ -113,6 +115,8 @@ public:
 
     /// Informs the expression that it is used to return the initialized object from an object initializer.
     void setIsInitReturn() { initReturn_ = true; }
+    /// The returned value.
+    const std::shared_ptr<ASTExpr>& value() const { return value_; }
 
 protected:
     void returnReference(FunctionAnalyser *analyser, Type type);
@@ -153,6 +153,11 @@ public:
     MFFlowCategory memoryFlowTypeForThis() const { return memoryFlowTypeThis_; }
     void setMemoryFlowTypeForThis(MFFlowCategory type) { memoryFlowTypeThis_ = type; }
 
+    /// Whether the memory flow of this function has been analysed. The memory flow type for this is already known
+    /// before if the function was declared with 🎍🥡, but its body must be analysed nonetheless.
+    bool memoryFlowAnalysed() const { return memoryFlowAnalysed_; }
+    void setMemoryFlowAnalysed() { memoryFlowAnalysed_ = true; }
+
     /// Whether this initializer might return an error.
     bool errorProne() const { return errorType_ != nullptr && errorType_->type().type() != TypeType::NoReturn; }
     ASTType* errorType() const { return errorType_.get(); }
@@ -186,6 +191,7 @@ private:
     FunctionType functionType_;
     size_t variableCount_ = 0;
     MFFlowCategory memoryFlowTypeThis_;
+    bool memoryFlowAnalysed_ = false;
 };
 
 }  // namespace EmojicodeCompiler
@@ -98,6 +98,11 @@ void buildDestructor(CodeGenerator *cg, TypeDefinition *typeDef) {
 
 
 std::pair<llvm::Function*, llvm::Function*> buildBoxRetainRelease(CodeGenerator *cg, const Type &type) {
+    if (!type.isManaged()) {
+        auto noRetainRelease = cg->runTime().noRetainRelease();
+        return std::make_pair(noRetainRelease, noRetainRelease);
+    }
+
     auto release = createFunction(cg, mangleBoxRelease(type));
     auto retain = createFunction(cg, mangleBoxRetain(type));
 
@@ -106,41 +111,39 @@ std::pair<llvm::Function*, llvm::Function*> buildBoxRetainRelease(CodeGenerator
     FunctionCodeGenerator retainFg(retain, cg, std::make_unique<TypeContext>(type));
     retainFg.createEntry();
 
-    if (type.isManaged()) {
-        if (!releaseFg.isManagedByReference(type)) {
-            auto objPtr = releaseFg.buildGetBoxValuePtr(release->args().begin(), type);
-            releaseFg.release(releaseFg.builder().CreateLoad(objPtr), type);
+    if (!releaseFg.isManagedByReference(type)) {
+        auto objPtr = releaseFg.buildGetBoxValuePtr(release->args().begin(), type);
+        releaseFg.release(releaseFg.builder().CreateLoad(objPtr), type);
 
-            auto objPtrRetain = retainFg.buildGetBoxValuePtr(retain->args().begin(), type);
-            retainFg.retain(retainFg.builder().CreateLoad(objPtrRetain), type);
-        }
-        else if (cg->typeHelper().isRemote(type)) {
-            auto containedType = cg->typeHelper().llvmTypeFor(type);
-            auto mngType = cg->typeHelper().managable(containedType);
-
-            auto objPtr = releaseFg.buildGetBoxValuePtrAfter(release->args().begin(), mngType->getPointerTo(),
-                                                             containedType->getPointerTo());
-            auto remotePtr = releaseFg.builder().CreateLoad(objPtr);
-            releaseFg.release(releaseFg.managableGetValuePtr(remotePtr), type);
-            releaseFg.builder().CreateCall(cg->runTime().releaseWithoutDeinit(),
-                                           releaseFg.builder().CreateBitCast(remotePtr,
-                                                                             llvm::Type::getInt8PtrTy(cg->context())));
-
-            auto objPtrRetain = retainFg.buildGetBoxValuePtrAfter(retain->args().begin(), mngType->getPointerTo(),
-                                                                  containedType->getPointerTo());
-            auto remotePtrRetain = retainFg.builder().CreateLoad(objPtrRetain);
-            retainFg.retain(retainFg.managableGetValuePtr(remotePtrRetain), type);
-            retainFg.builder().CreateCall(cg->runTime().retain(),
-                                          retainFg.builder().CreateBitCast(remotePtrRetain,
-                                                                           llvm::Type::getInt8PtrTy(cg->context())));
-        }
-        else {
-            auto objPtr = releaseFg.buildGetBoxValuePtr(release->args().begin(), type);
-            releaseFg.release(objPtr, type);
+        auto objPtrRetain = retainFg.buildGetBoxValuePtr(retain->args().begin(), type);
+        retainFg.retain(retainFg.builder().CreateLoad(objPtrRetain), type);
+    }
+    else if (cg->typeHelper().isRemote(type)) {
+        auto containedType = cg->typeHelper().llvmTypeFor(type);
+        auto mngType = cg->typeHelper().managable(containedType);
+
+        auto objPtr = releaseFg.buildGetBoxValuePtrAfter(release->args().begin(), mngType->getPointerTo(),
+                                                         containedType->getPointerTo());
+        auto remotePtr = releaseFg.builder().CreateLoad(objPtr);
+        releaseFg.release(releaseFg.managableGetValuePtr(remotePtr), type);
+        releaseFg.builder().CreateCall(cg->runTime().releaseWithoutDeinit(),
+                                       releaseFg.builder().CreateBitCast(remotePtr,
+                                                                         llvm::Type::getInt8PtrTy(cg->context())));
+
+        auto objPtrRetain = retainFg.buildGetBoxValuePtrAfter(retain->args().begin(), mngType->getPointerTo(),
+                                                              containedType->getPointerTo());
+        auto remotePtrRetain = retainFg.builder().CreateLoad(objPtrRetain);
+        retainFg.retain(retainFg.managableGetValuePtr(remotePtrRetain), type);
+        retainFg.builder().CreateCall(cg->runTime().retain(),
+                                      retainFg.builder().CreateBitCast(remotePtrRetain,
+                                                                       llvm::Type::getInt8PtrTy(cg->context())));
+    }
+    else {
+        auto objPtr = releaseFg.buildGetBoxValuePtr(release->args().begin(), type);
+        releaseFg.release(objPtr, type);
 
-            auto objPtrRetain = retainFg.buildGetBoxValuePtr(retain->args().begin(), type);
-            retainFg.retain(objPtrRetain, type);
-        }
+        auto objPtrRetain = retainFg.buildGetBoxValuePtr(retain->args().begin(), type);
+        retainFg.retain(objPtrRetain, type);
     }
 
     releaseFg.builder().CreateRetVoid();
@@ -463,7 +463,48 @@ void FunctionCodeGenerator::retain(llvm::Value *value, const Type &otype) {
     }
 }
 
-void FunctionCodeGenerator::manageBox(bool retain, llvm::Value *boxInfo, llvm::Value *value, const Type &type) {
+void FunctionCodeGenerator::retainValues(llvm::Value *ptr, llvm::Value *count, const Type &otype) {
+    auto type = otype.resolveOnSuperArgumentsAndConstraints(*typeContext_);
+    if (!type.isManaged()) {
+        return;
+    }
+
+    auto entry = builder().GetInsertBlock();
+    auto condBlock = createBlock("retainValues");
+    auto bodyBlock = createBlock("retainValuesBody");
+    auto endBlock = createBlock("retainValuesEnd");
+    builder().CreateBr(condBlock);
+
+    builder().SetInsertPoint(condBlock);
+    auto index = builder().CreatePHI(builder().getInt64Ty(), 2);
+    index->addIncoming(int64(0), entry);
+    builder().CreateCondBr(builder().CreateICmpSLT(index, count), bodyBlock, endBlock);
+
+    builder().SetInsertPoint(bodyBlock);
+    auto elementPtr = builder().CreateInBoundsGEP(ptr, index);
+    if (type.type() == TypeType::Box) {
+        auto boxInfo = builder().CreateLoad(buildGetBoxInfoPtr(elementPtr));
+        if (type.unboxed().type() == TypeType::Optional || type.unboxed().type() == TypeType::Something) {
+            auto null = llvm::ConstantPointerNull::get(typeHelper().boxInfo()->getPointerTo());
+            createIf(builder().CreateICmpNE(boxInfo, null), [&] {
+                manageBox(true, boxInfo, elementPtr, type, true);
+            });
+        }
+        else {
+            manageBox(true, boxInfo, elementPtr, type, true);
+        }
+    }
+    else {
+        retain(isManagedByReference(type) ? elementPtr : builder().CreateLoad(elementPtr), type);
+    }
+    index->addIncoming(builder().CreateAdd(index, int64(1)), builder().GetInsertBlock());
+    builder().CreateBr(condBlock);
+
+    builder().SetInsertPoint(endBlock);
+}
+
+void FunctionCodeGenerator::manageBox(bool retain, llvm::Value *boxInfo, llvm::Value *value, const Type &type,
+                                      bool skipNoRetainRelease) {
     llvm::Value *fnPtr;
     if (type.boxedFor().type() == TypeType::Protocol) {
         auto conf = builder().CreateBitCast(boxInfo, typeHelper().protocolConformance()->getPointerTo());
@@ -472,10 +513,19 @@ void FunctionCodeGenerator::manageBox(bool retain, llvm::Value *boxInfo, llvm::V
     else {
         fnPtr = builder().CreateConstInBoundsGEP2_32(typeHelper().boxInfo(), boxInfo, 0, retain ? 1 : 2);
     }
-    auto call = builder().CreateCall(builder().CreateLoad(fnPtr, retain ? "retain" : "release"), value);
-    call->addParamAttr(0, llvm::Attribute::NoCapture);
-    call->addParamAttr(0, llvm::Attribute::ReadOnly);
-    call->addAttribute(llvm::AttributeList::FunctionIndex, llvm::Attribute::NoUnwind);
+    auto fn = builder().CreateLoad(fnPtr, retain ? "retain" : "release");
+    auto call = [&] {
+        auto call = builder().CreateCall(fn, value);
+        call->addParamAttr(0, llvm::Attribute::NoCapture);
+        call->addParamAttr(0, llvm::Attribute::ReadOnly);
+        call->addAttribute(llvm::AttributeList::FunctionIndex, llvm::Attribute::NoUnwind);
+    };
+    if (skipNoRetainRelease) {
+        createIf(builder().CreateICmpNE(fn, generator()->runTime().noRetainRelease()), call);
+    }
+    else {
+        call();
+    }
 }
 
 bool FunctionCodeGenerator::isManagedByReference(const Type &type) const {
@@ -167,6 +167,9 @@ public:
     /// @param ptr Pointer to the value to be released.
     void releaseByReference(llvm::Value *ptr, const Type &type);
     void retain(llvm::Value *value, const Type &type);
+    /// Retains @p count values of type @p type which are stored consecutively in memory beginning at @p ptr.
+    /// Boxes whose retain function is RunTimeHelper::noRetainRelease() are skipped without calling it.
+    void retainValues(llvm::Value *ptr, llvm::Value *count, const Type &type);
     bool isManagedByReference(const Type &type) const;
 
     llvm::Value* createEntryAlloca(llvm::Type *type, const llvm::Twine &name = "");
@@ -231,7 +234,9 @@ private:
     std::unique_ptr<TypeContext> typeContext_;
 
     /// @param retain True if the box should be released, false if it should be retained.
-    void manageBox(bool retain, llvm::Value *boxInfo, llvm::Value *value, const Type &type);
+    /// @param skipNoRetainRelease If true, no call is made if the function is RunTimeHelper::noRetainRelease().
+    void manageBox(bool retain, llvm::Value *boxInfo, llvm::Value *value, const Type &type,
+                   bool skipNoRetainRelease = false);
 
     void addParamAttrs(const Type &argType, llvm::Argument &llvmArg);
 };
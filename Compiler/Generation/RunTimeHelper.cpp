@@ -28,6 +28,13 @@ void RunTimeHelper::declareRunTime() {
     alloc_->addFnAttr(llvm::Attribute::getWithAllocSizeArgs(generator_->context(), 0, llvm::Optional<unsigned>()));
     alloc_->addAttribute(llvm::AttributeList::ReturnIndex, llvm::Attribute::NoAlias);
 
+    allocMemory_ = declareRunTimeFunction("ejcAllocMemory", llvm::Type::getInt8PtrTy(generator_->context()),
+                                          llvm::Type::getInt64Ty(generator_->context()));
+    allocMemory_->addAttribute(0, llvm::Attribute::NonNull);
+    allocMemory_->addFnAttr(llvm::Attribute::getWithAllocSizeArgs(generator_->context(), 0,
+                                                                  llvm::Optional<unsigned>()));
+    allocMemory_->addAttribute(llvm::AttributeList::ReturnIndex, llvm::Attribute::NoAlias);
+
     panic_ = declareRunTimeFunction("ejcPanic", llvm::Type::getVoidTy(generator_->context()),
                                     llvm::Type::getInt8PtrTy(generator_->context()));
     panic_->addFnAttr(llvm::Attribute::NoReturn);
@@ -96,6 +103,15 @@ void RunTimeHelper::declareRunTime() {
     isOnlyReference_->addParamAttr(0, llvm::Attribute::NonNull);
     isOnlyReference_->addParamAttr(0, llvm::Attribute::NoCapture);
 
+    auto threadExitFunction = llvm::FunctionType::get(llvm::Type::getVoidTy(generator_->context()), false);
+    releaseAtThreadExit_ = declareRunTimeFunction("ejcReleaseAtThreadExit", llvm::Type::getVoidTy(generator_->context()),
+                                                  threadExitFunction->getPointerTo());
+    releaseAtThreadExit_->addParamAttr(0, llvm::Attribute::NonNull);
+
+    noRetainRelease_ = declareRunTimeFunction("ejcNoRetainRelease", llvm::Type::getVoidTy(generator_->context()),
+                                              generator_->typeHelper().boxRetainRelease()->getParamType(0));
+    noRetainRelease_->addFnAttr(llvm::Attribute::ReadNone);
+
     ignoreBlock_ = new llvm::GlobalVariable(*generator_->module(), llvm::Type::getInt8Ty(generator_->context()), true,
                                             llvm::GlobalValue::LinkageTypes::ExternalLinkage, nullptr,
                                             "ejcIgnoreBlock");
@@ -31,6 +31,9 @@ public:
 
     /// The allocator function that is called to allocate all heap memory. (ejcAlloc)
     llvm::Function* alloc() const { return alloc_; }
+    /// The allocator function that is called to allocate memory areas, i.e. 🧠 and value type generic arguments, which
+    /// must be released with releaseMemory(). (ejcAllocMemory)
+    llvm::Function* allocMemory() const { return allocMemory_; }
     /// The panic method, which is called if the program panics due to e.g. unwrapping an empty optional. (ejcPanic)
     llvm::Function* panic() const { return panic_; }
     /// The function that is called to determine if one class inherits from another. (ejcInheritsFrom)
@@ -56,6 +59,9 @@ public:
     /// (ejcReleaseCapture)
     /// @see release
     llvm::Function* releaseCapture() const { return releaseCapture_; }
+    /// The box retain and release function of all types that are not managed. It does nothing and allows code that
+    /// retains many boxes to skip the call. (ejcNoRetainRelease)
+    llvm::Function* noRetainRelease() const { return noRetainRelease_; }
     /// Used to find a protocol conformance in an array of ProtocolConformanceEntries. (ejcFindProtocolConformance)
     llvm::Function* findProtocolConformance() const { return findProtocolConformance_; }
 
@@ -67,6 +73,9 @@ public:
     llvm::Function* indexTypeDescription() const { return indexTypeDescription_; }
 
     llvm::Function* isOnlyReference() const { return isOnlyReference_; }
+    /// The function that registers a function to be called when the calling thread exits, which is used to release
+    /// thread-local values. (ejcReleaseAtThreadExit)
+    llvm::Function* releaseAtThreadExit() const { return releaseAtThreadExit_; }
 
     llvm::GlobalVariable* ignoreBlockPtr() const { return ignoreBlock_; }
 
@@ -87,6 +96,7 @@ private:
     CodeGenerator *generator_;
 
     llvm::Function *alloc_ = nullptr;
+    llvm::Function *allocMemory_ = nullptr;
     llvm::Function *panic_ = nullptr;
 
     llvm::Function *inheritsFrom_ = nullptr;
@@ -107,6 +117,8 @@ private:
     llvm::Function *releaseWithoutDeinit_ = nullptr;
     llvm::Function *releaseLocal_ = nullptr;
     llvm::Function *isOnlyReference_ = nullptr;
+    llvm::Function *releaseAtThreadExit_ = nullptr;
+    llvm::Function *noRetainRelease_ = nullptr;
 
     llvm::Function *malloc_ = nullptr;
     llvm::Function *free_ = nullptr;
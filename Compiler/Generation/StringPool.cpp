@@ -14,6 +14,8 @@
 #include "Types/Class.hpp"
 #include <llvm/IR/Constants.h>
 #include <llvm/IR/GlobalVariable.h>
+#include <algorithm>
+#include <cstdint>
 
 namespace EmojicodeCompiler {
 
@@ -44,14 +46,19 @@ llvm::Value* StringPool::addToPool(const std::string &string) {
 
     auto varCast = llvm::ConstantExpr::getBitCast(var, llvm::Type::getInt8PtrTy(codeGenerator_->context()));
 
+    // The hash is not known yet, but whether the string consists of ASCII characters only is. It is stored in the
+    // highest bit of the hash field, see s::String::kASCII.
+    auto ascii = std::all_of(string.begin(), string.end(), [](char c) { return static_cast<uint8_t>(c) < 0x80; });
     auto stringStruct = llvm::ConstantStruct::get(stringLlvm, {
         codeGenerator_->runTime().ignoreBlockPtr(),
         compiler->sString->classInfo(),
         varCast,
-        llvm::ConstantInt::get(llvm::Type::getInt64Ty(codeGenerator_->context()), string.size())
+        llvm::ConstantInt::get(llvm::Type::getInt64Ty(codeGenerator_->context()), string.size()),
+        llvm::ConstantInt::get(llvm::Type::getInt64Ty(codeGenerator_->context()), ascii ? INT64_MIN : 0)
     });
 
-    auto stringVar = new llvm::GlobalVariable(*codeGenerator_->module(), stringLlvm, true,
+    // Not constant: The hash of the string is stored in the object the first time it is computed.
+    auto stringVar = new llvm::GlobalVariable(*codeGenerator_->module(), stringLlvm, false,
                                               llvm::GlobalValue::LinkageTypes::PrivateLinkage, stringStruct, "string");
     return stringVar;
 }
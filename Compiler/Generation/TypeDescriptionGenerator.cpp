@@ -134,7 +134,7 @@ llvm::Value* TypeDescriptionGenerator::finish() {
         }
         else {
             auto size = fg_->builder().CreateAdd(fg_->sizeOf(llvm::Type::getInt8PtrTy(fg_->ctx())), allocSize);
-            auto allocUncasted = fg_->builder().CreateCall(fg_->generator()->runTime().alloc(), size);
+            auto allocUncasted = fg_->builder().CreateCall(fg_->generator()->runTime().allocMemory(), size);
             auto type = fg_->typeHelper().managable(fg_->typeHelper().typeDescription());
             alloc = fg_->builder().CreateBitCast(allocUncasted, type->getPointerTo());
             current = fg_->builder().CreateConstInBoundsGEP2_32(type, alloc, 0, 1);
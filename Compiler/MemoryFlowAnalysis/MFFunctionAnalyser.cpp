@@ -29,11 +29,15 @@ const MFFlowCategory MFFlowCategory::Return = MFFlowCategory::Category::Return;
 MFFunctionAnalyser::MFFunctionAnalyser(Function *function) : scope_(function->variableCount()), function_(function) {}
 
 void MFFunctionAnalyser::analyse() {
-    if (!function_->memoryFlowTypeForThis().isUnknown()) {
+    if (function_->memoryFlowAnalysed() || function_->ast() == nullptr) {
         return;
     }
+    function_->setMemoryFlowAnalysed();
 
-    function_->setMemoryFlowTypeForThis(MFFlowCategory::Escaping);
+    auto declaredThis = function_->memoryFlowTypeForThis();
+    if (declaredThis.isUnknown()) {
+        function_->setMemoryFlowTypeForThis(MFFlowCategory::Escaping);
+    }
 
     for (size_t i = 0; i < function_->parameters().size(); i++) {
         auto &var = scope_.getVariable(i);
@@ -43,7 +47,9 @@ void MFFunctionAnalyser::analyse() {
     }
 
     function_->ast()->analyseMemoryFlow(this);
-    function_->setMemoryFlowTypeForThis(thisEscapes_ ? MFFlowCategory::Escaping : MFFlowCategory::Borrowing);
+    if (declaredThis.isUnknown()) {
+        function_->setMemoryFlowTypeForThis(thisEscapes_ ? MFFlowCategory::Escaping : MFFlowCategory::Borrowing);
+    }
 
     popScope(function_->ast());
 
@@ -78,7 +84,7 @@ void MFFunctionAnalyser::checkMFPromises() const {
 }
 
 void MFFunctionAnalyser::analyseIfNecessary(Function *function) const {
-    if (function->memoryFlowTypeForThis().isUnknown()) {
+    if (!function->memoryFlowAnalysed()) {
         MFFunctionAnalyser(function).analyse();
     }
 }
@@ -243,10 +243,14 @@ void PrettyPrinter::printMethodsAndInitializers(TypeDefinition *typeDef) {
 }
 
 void PrettyPrinter::printProtocolConformances(TypeDefinition *typeDef, const TypeContext &typeContext) {
-    for (auto &protocol : typeDef->protocols()) {
-        prettyStream_.indent() << "🐊 " << protocol.type << "\n";
+    auto &protocols = typeDef->protocols();
+    auto count = typeDef->declaredProtocolsCount();
+    for (size_t i = 0; i < count; i++) {
+        prettyStream_.indent() << "🐊 " << protocols[i].type << "\n";
+    }
+    if (count > 0) {
+        prettyStream_.offerNewLine();
     }
-    prettyStream_.offerNewLineUnlessEmpty(typeDef->protocols());
 }
 
 void PrettyPrinter::printInstanceVariables(TypeDefinition *typeDef, const TypeContext &typeContext) {
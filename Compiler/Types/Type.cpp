@@ -220,6 +220,10 @@ Type Type::resolveOnSuperArgumentsAndConstraints(const TypeContext &typeContext)
     bool mut = mutable_;
     if (type() == TypeType::Optional) {
         t.genericArguments_[0] = genericArguments_[0].resolveOnSuperArgumentsAndConstraints(typeContext);
+        if (t.genericArguments_[0].type() == TypeType::Box) {
+            // The constraint of a generic variable may be boxed, but the box must contain the optional.
+            return t.genericArguments_[0].optionalized();
+        }
         return t;
     }
     if (type() == TypeType::Box) {
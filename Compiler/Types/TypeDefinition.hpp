@@ -84,9 +84,15 @@ public:
     FunctionResolver<Initializer>& inits() { return inits_; }
 
     /// Declares conformance of the type to a protocol.
-    void addProtocol(std::shared_ptr<ASTType> type) { protocols_.emplace_back(std::move(type)); }
+    void addProtocol(std::shared_ptr<ASTType> type) {
+        protocols_.emplace_back(std::move(type));
+        declaredProtocolsCount_++;
+    }
     /** Returns a list of all protocols to which this class conforms. */
     std::vector<ProtocolConformance>& protocols() { return protocols_; }
+    /// Returns the number of protocols to which the type itself declared conformance. These come first in protocols(),
+    /// which also contains the conformances a class inherits from its superclass once it was analysed.
+    size_t declaredProtocolsCount() const { return declaredProtocolsCount_; }
 
     /// Calls the given function with every Function that is defined for this TypeDefinition, i.e. all methods,
     /// type methods and initializers.
@@ -143,6 +149,7 @@ private:
 
     bool exported_;
     bool genericDynamismDisabled_ = false;
+    size_t declaredProtocolsCount_ = 0;
 
     std::map<Type, llvm::Constant*> protocolTables_;
 
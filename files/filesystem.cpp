@@ -82,7 +82,12 @@ extern "C" String* filesFsAbsolute(String *inPath, runtime::Raiser *raiser) {
     if (x == nullptr) {
         EJC_RAISE(raiser, s::IOError::init());
     }
-    return String::init(x);
+    auto string = String::initValidating(x);
+    if (string == nullptr) {
+        errno = EILSEQ;
+        EJC_RAISE(raiser, s::IOError::init());
+    }
+    return string;
 }
 
 }  // namespace files
@@ -24,7 +24,10 @@ struct Capture;
 }
 }
 
+extern runtime::internal::ControlBlock ejcIgnoreBlock;
+
 extern "C" int8_t* ejcAlloc(int64_t size);
+extern "C" int8_t* ejcAllocMemory(int64_t size);
 extern "C" [[noreturn]] void ejcPanic(const char *message);
 
 namespace runtime {
@@ -65,6 +68,8 @@ template <typename T>
 class MemoryPointer {
     template <typename TA>
     friend inline MemoryPointer<TA> allocate(int64_t n);
+    template <typename TA>
+    friend inline MemoryPointer<TA> placeUnmanaged(int8_t *storage);
 public:
     MemoryPointer() {}
     T* get() const {
@@ -85,7 +90,15 @@ private:
 
 template <typename T>
 inline MemoryPointer<T> allocate(int64_t n = 1) {
-    return MemoryPointer<T>(ejcAlloc(sizeof(T) * n + sizeof(runtime::internal::ControlBlock *)));
+    return MemoryPointer<T>(ejcAllocMemory(sizeof(T) * n + sizeof(runtime::internal::ControlBlock *)));
+}
+
+/// Places a memory area at @c storage, which must provide space for a pointer followed by the elements.
+/// The memory area is not reference counted: It must not be used after the storage has been freed.
+template <typename T>
+inline MemoryPointer<T> placeUnmanaged(int8_t *storage) {
+    *reinterpret_cast<runtime::internal::ControlBlock **>(storage) = &ejcIgnoreBlock;
+    return MemoryPointer<T>(storage);
 }
 
 template <typename Subclass>
@@ -100,6 +113,15 @@ public:
         return new(malloc(sizeof(Subclass))) Subclass(std::forward<Args>(args)...);
     }
 
+    /// Like init() but allocates @c size additional bytes directly after the object, which it can use to store
+    /// data without a separate allocation. They are freed together with the object.
+    template <typename ...Args>
+    static Subclass* initWithStorage(size_t size, Args&& ...args) {
+        static_assert(util::is_complete<ClassInfoFor<Subclass>>::value,
+                      "Provide class info for this class with SET_INFO_FOR.");
+        return new(malloc(sizeof(Subclass) + size)) Subclass(std::forward<Args>(args)...);
+    }
+
     internal::ControlBlock* controlBlock() const { return block_; }
     const ClassInfo* classInfo() const { return classInfo_; }
 
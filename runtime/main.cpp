@@ -13,6 +13,7 @@
 #include <cstring>
 #include <iostream>
 #include <random>
+#include <vector>
 
 runtime::internal::ControlBlock ejcIgnoreBlock;
 
@@ -32,6 +33,25 @@ extern "C" int8_t* ejcAlloc(runtime::Integer size) {
     return static_cast<int8_t*>(ptr);
 }
 
+/// Memory areas are never referenced weakly, which allows their control block to live in the same allocation. It is
+/// placed after the memory area so that the area can be reallocated without moving its content.
+size_t memoryControlBlockOffset(runtime::Integer size) {
+    auto alignment = alignof(runtime::internal::ControlBlock);
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+runtime::internal::ControlBlock* placeMemoryControlBlock(int8_t *ptr, runtime::Integer size) {
+    auto block = new (ptr + memoryControlBlockOffset(size)) runtime::internal::ControlBlock;
+    *reinterpret_cast<runtime::internal::ControlBlock**>(ptr) = block;
+    return block;
+}
+
+extern "C" int8_t* ejcAllocMemory(runtime::Integer size) {
+    auto ptr = static_cast<int8_t*>(malloc(memoryControlBlockOffset(size) + sizeof(runtime::internal::ControlBlock)));
+    placeMemoryControlBlock(ptr, size);
+    return ptr;
+}
+
 extern "C" void ejcRetain(runtime::Object<void> *object) {
     runtime::internal::ControlBlock *controlBlock = object->controlBlock();
     if (controlBlock == nullptr) {
@@ -49,6 +69,8 @@ extern "C" void ejcRetainMemory(runtime::Object<void> *object) {
     controlBlock->strongCount.fetch_add(1, std::memory_order_relaxed);
 }
 
+extern "C" void ejcNoRetainRelease(void *box) {}
+
 bool releaseLocal(void *object) {
     auto &ptr = *reinterpret_cast<int64_t *>(reinterpret_cast<uint8_t *>(object) - 8);
     ptr--;
@@ -107,7 +129,6 @@ extern "C" void ejcReleaseMemory(runtime::Object<void> *object) {
 
     if (controlBlock->strongCount.fetch_sub(1, std::memory_order_acq_rel) - 1 != 0) return;
 
-    delete controlBlock;
     free(object);
 }
 
@@ -231,7 +252,12 @@ extern "C" TypeDescription* ejcIndexTypeDescription(TypeDescription *arg, runtim
 }
 
 extern "C" void ejcMemoryRealloc(int8_t **pointerPtr, runtime::Integer newSize) {
-    *pointerPtr = static_cast<int8_t*>(realloc(*pointerPtr, newSize + sizeof(runtime::internal::ControlBlock*)));
+    auto size = newSize + sizeof(runtime::internal::ControlBlock*);
+    auto strongCount = (*reinterpret_cast<runtime::internal::ControlBlock**>(*pointerPtr))->strongCount.load();
+    auto ptr = static_cast<int8_t*>(realloc(*pointerPtr, memoryControlBlockOffset(size) +
+                                                         sizeof(runtime::internal::ControlBlock)));
+    placeMemoryControlBlock(ptr, size)->strongCount = strongCount;
+    *pointerPtr = ptr;
 }
 
 extern "C" runtime::Integer ejcMemoryCompare(int8_t **self, int8_t *other, runtime::Integer bytes) {
@@ -248,6 +274,27 @@ extern "C" bool ejcIsOnlyReference(runtime::Object<void> *object) {
     return controlBlock->strongCount == 1;
 }
 
+extern "C" bool ejcMemoryIsOnlyReference(int8_t **self, runtime::Integer offset) {
+    auto object = *reinterpret_cast<runtime::Object<void> **>(*self + sizeof(runtime::internal::ControlBlock*) + offset);
+    return ejcIsOnlyReference(object);
+}
+
+/// Calls the functions registered by a thread with ejcReleaseAtThreadExit() when the thread exits.
+struct ThreadExitReleases {
+    std::vector<void (*)()> functions;
+
+    ~ThreadExitReleases() {
+        for (auto function : functions) {
+            function();
+        }
+    }
+};
+
+extern "C" void ejcReleaseAtThreadExit(void (*function)()) {
+    static thread_local ThreadExitReleases releases;
+    releases.functions.emplace_back(function);
+}
+
 extern "C" [[noreturn]] void ejcPanic(const char *message) {
     std::cout << "🤯 Program panicked: " << message << std::endl;
     abort();
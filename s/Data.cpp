@@ -4,9 +4,10 @@
 
 #include "../runtime/Runtime.h"
 #include "Data.h"
+#include "Search.h"
 #include "String.h"
+#include "UTF8.h"
 #include "utf8proc.h"
-#include <algorithm>
 
 namespace s {
 
@@ -16,7 +17,7 @@ extern "C" runtime::SimpleOptional<runtime::Integer> sDataFindFromIndex(Data *da
         return runtime::NoValue;
     }
     auto end = data->data.get() + data->count;
-    auto pos = std::search(data->data.get() + offset, end, search->data.get(), search->data.get() + search->count);
+    auto pos = Searcher(search->data.get(), search->count).find(data->data.get() + offset, end);
     if (pos != end) {
         return pos - data->data.get();
     }
@@ -24,14 +25,18 @@ extern "C" runtime::SimpleOptional<runtime::Integer> sDataFindFromIndex(Data *da
 }
 
 extern "C" runtime::SimpleOptional<String *> sDataAsString(Data *data) {
-    auto chars = reinterpret_cast<char *>(data->data.get());
-
-    // TODO: validate
+    auto validation = validateUTF8(reinterpret_cast<char *>(data->data.get()), data->count);
+    if (!validation.valid) {
+        return runtime::NoValue;
+    }
 
     auto *string = String::init();
     string->count = data->count;
     string->characters = data->data;
     data->data.retain();
+    if (validation.ascii) {
+        string->setASCII();
+    }
     return string;
 }
 
@@ -0,0 +1,327 @@
+//
+//  Format.cpp
+//  Emojicode
+//
+
+#include "Format.h"
+#include "RealTables.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace s {
+
+namespace {
+
+__extension__ typedef unsigned __int128 UInt128;
+
+const char kDigitPairs[] =
+        "0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+        "5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+const uint64_t kPowersOf10[] = {
+    1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u, 100000000u, 1000000000u, 10000000000u,
+    100000000000u, 1000000000000u, 10000000000000u, 100000000000000u, 1000000000000000u, 10000000000000000u,
+    100000000000000000u, 1000000000000000000u, 10000000000000000000u,
+};
+
+/// Writes the decimal digits of @c value so that they end right before @c end.
+void writeDigits(char *end, uint64_t value) {
+    while (value >= 100) {
+        auto pair = value % 100;
+        value /= 100;
+        end -= 2;
+        std::memcpy(end, kDigitPairs + pair * 2, 2);
+    }
+    if (value >= 10) {
+        std::memcpy(end - 2, kDigitPairs + value * 2, 2);
+    }
+    else {
+        end[-1] = static_cast<char>('0' + value);
+    }
+}
+
+/// Returns the number of bits of 5^e, or 1 if e is 0. Exact for 0 <= e <= 3528.
+int32_t pow5Bits(int32_t e) {
+    return static_cast<int32_t>((static_cast<uint32_t>(e) * 1217359) >> 19) + 1;
+}
+
+/// Returns floor(log10(2^e)). Exact for 0 <= e <= 1650.
+int32_t log10Pow2(int32_t e) {
+    return static_cast<int32_t>((static_cast<uint32_t>(e) * 78913) >> 18);
+}
+
+/// Returns floor(log10(5^e)). Exact for 0 <= e <= 2620.
+int32_t log10Pow5(int32_t e) {
+    return static_cast<int32_t>((static_cast<uint32_t>(e) * 732923) >> 20);
+}
+
+bool multipleOfPowerOf5(uint64_t value, int32_t p) {
+    int32_t count = 0;
+    while (value % 5 == 0) {
+        value /= 5;
+        count++;
+    }
+    return count >= p;
+}
+
+bool multipleOfPowerOf2(uint64_t value, int32_t p) {
+    return (value & ((uint64_t(1) << p) - 1)) == 0;
+}
+
+/// Returns (m × mul) >> j, where mul is a 128-bit factor from one of the tables and j is at least 64.
+uint64_t mulShift(uint64_t m, const uint64_t *mul, int32_t j) {
+    auto low = static_cast<UInt128>(m) * mul[0];
+    auto high = static_cast<UInt128>(m) * mul[1];
+    return static_cast<uint64_t>(((low >> 64) + high) >> (j - 64));
+}
+
+}  // namespace
+
+unsigned decimalLength(uint64_t value) {
+    if (value < 10) {
+        return 1;
+    }
+    // floor(log10(2) × bit length) is the number of digits minus one or two.
+    auto estimate = ((64 - __builtin_clzll(value)) * 1233) >> 12;
+    return estimate + (value >= kPowersOf10[estimate] ? 1 : 0);
+}
+
+size_t writeDecimal(char *buffer, int64_t value) {
+    auto p = buffer;
+    auto magnitude = static_cast<uint64_t>(value);
+    if (value < 0) {
+        *p++ = '-';
+        magnitude = 0 - magnitude;
+    }
+    auto length = decimalLength(magnitude);
+    writeDigits(p + length, magnitude);
+    return p + length - buffer;
+}
+
+Decimal shortestDecimal(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    auto ieeeMantissa = bits & ((uint64_t(1) << 52) - 1);
+    auto ieeeExponent = static_cast<int32_t>((bits >> 52) & 0x7FF);
+    if (ieeeMantissa == 0 && ieeeExponent == 0) {
+        return Decimal { 0, 0 };
+    }
+
+    // The value is m2 × 2^e2. Two more bits are used to represent the halfway points to the neighbouring values.
+    int32_t e2;
+    uint64_t m2;
+    if (ieeeExponent == 0) {
+        e2 = 1 - 1023 - 52 - 2;
+        m2 = ieeeMantissa;
+    }
+    else {
+        e2 = ieeeExponent - 1023 - 52 - 2;
+        m2 = (uint64_t(1) << 52) | ieeeMantissa;
+    }
+    bool acceptBounds = (m2 & 1) == 0;
+
+    // The interval of values converting to this double is (mv - mmShift - 1, mv + 2) × 2^e2.
+    auto mv = 4 * m2;
+    uint32_t mmShift = ieeeMantissa != 0 || ieeeExponent <= 1;
+
+    // Compute the interval in decimal, i.e. vr × 10^e10 and its bounds vm and vp.
+    uint64_t vr, vp, vm;
+    int32_t e10;
+    bool vmIsTrailingZeros = false, vrIsTrailingZeros = false;
+    if (e2 >= 0) {
+        auto q = log10Pow2(e2) - (e2 > 3);
+        e10 = q;
+        auto k = static_cast<int32_t>(kPow5InverseBitCount) + pow5Bits(q) - 1;
+        auto i = -e2 + q + k;
+        vr = mulShift(mv, kPow5InverseSplit[q], i);
+        vp = mulShift(mv + 2, kPow5InverseSplit[q], i);
+        vm = mulShift(mv - 1 - mmShift, kPow5InverseSplit[q], i);
+        if (q <= 21) {
+            // Only one of mp, mv and mm can be a multiple of 5, if any.
+            if (mv % 5 == 0) {
+                vrIsTrailingZeros = multipleOfPowerOf5(mv, q);
+            }
+            else if (acceptBounds) {
+                vmIsTrailingZeros = multipleOfPowerOf5(mv - 1 - mmShift, q);
+            }
+            else {
+                vp -= multipleOfPowerOf5(mv + 2, q);
+            }
+        }
+    }
+    else {
+        auto q = log10Pow5(-e2) - (-e2 > 1);
+        e10 = q + e2;
+        auto i = -e2 - q;
+        auto k = pow5Bits(i) - static_cast<int32_t>(kPow5BitCount);
+        auto j = q - k;
+        vr = mulShift(mv, kPow5Split[i], j);
+        vp = mulShift(mv + 2, kPow5Split[i], j);
+        vm = mulShift(mv - 1 - mmShift, kPow5Split[i], j);
+        if (q <= 1) {
+            // mv has at least two trailing zero bits, so vr has at least q trailing zero digits.
+            vrIsTrailingZeros = true;
+            if (acceptBounds) {
+                vmIsTrailingZeros = mmShift == 1;
+            }
+            else {
+                vp--;
+            }
+        }
+        else if (q < 63) {
+            vrIsTrailingZeros = multipleOfPowerOf2(mv, q);
+        }
+    }
+
+    // Remove as many digits as possible while staying within the interval.
+    int32_t removed = 0;
+    uint64_t lastRemovedDigit = 0;
+    uint64_t output;
+    if (vmIsTrailingZeros || vrIsTrailingZeros) {
+        while (vp / 10 > vm / 10) {
+            vmIsTrailingZeros &= vm % 10 == 0;
+            vrIsTrailingZeros &= lastRemovedDigit == 0;
+            lastRemovedDigit = vr % 10;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        if (vmIsTrailingZeros) {
+            while (vm % 10 == 0) {
+                vrIsTrailingZeros &= lastRemovedDigit == 0;
+                lastRemovedDigit = vr % 10;
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed++;
+            }
+        }
+        if (vrIsTrailingZeros && lastRemovedDigit == 5 && vr % 2 == 0) {
+            // Exactly halfway between two candidates, round to even.
+            lastRemovedDigit = 4;
+        }
+        output = vr + ((vr == vm && (!acceptBounds || !vmIsTrailingZeros)) || lastRemovedDigit >= 5);
+    }
+    else {
+        // The common case, in which the bounds and vr are not exact.
+        bool roundUp = false;
+        if (vp / 100 > vm / 100) {
+            roundUp = vr % 100 >= 50;
+            vr /= 100;
+            vp /= 100;
+            vm /= 100;
+            removed += 2;
+        }
+        while (vp / 10 > vm / 10) {
+            roundUp = vr % 10 >= 5;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        output = vr + (vr == vm || roundUp);
+    }
+    return Decimal { output, e10 + removed };
+}
+
+size_t writeShortest(char *buffer, double value) {
+    auto p = buffer;
+    if (std::isnan(value)) {
+        std::memcpy(p, "nan", 3);
+        return 3;
+    }
+    if (std::signbit(value)) {
+        *p++ = '-';
+        value = -value;
+    }
+    if (std::isinf(value)) {
+        std::memcpy(p, "inf", 3);
+        return p + 3 - buffer;
+    }
+
+    auto decimal = shortestDecimal(value);
+    auto length = static_cast<int32_t>(decimalLength(decimal.digits));
+    auto exponent = decimal.exponent + length - 1;
+    if (exponent >= 16 || exponent < -4) {
+        // Write the digits one to the right and move the first digit before the decimal separator.
+        writeDigits(p + length + 1, decimal.digits);
+        p[0] = p[1];
+        if (length > 1) {
+            p[1] = '.';
+            p += length + 1;
+        }
+        else {
+            p++;
+        }
+        *p++ = 'e';
+        *p++ = exponent < 0 ? '-' : '+';
+        auto magnitude = static_cast<uint64_t>(std::abs(exponent));
+        if (magnitude < 10) {
+            *p++ = '0';
+        }
+        auto exponentLength = decimalLength(magnitude);
+        writeDigits(p + exponentLength, magnitude);
+        return p + exponentLength - buffer;
+    }
+
+    if (exponent < 0) {
+        std::memcpy(p, "0.", 2);
+        std::memset(p + 2, '0', -exponent - 1);
+        p += 1 - exponent;
+        writeDigits(p + length, decimal.digits);
+        return p + length - buffer;
+    }
+    if (exponent + 1 >= length) {
+        writeDigits(p + length, decimal.digits);
+        std::memset(p + length, '0', exponent + 1 - length);
+        p += exponent + 1;
+        std::memcpy(p, ".0", 2);
+        return p + 2 - buffer;
+    }
+    writeDigits(p + length + 1, decimal.digits);
+    std::memmove(p, p + 1, exponent + 1);
+    p[exponent + 1] = '.';
+    return p + length + 1 - buffer;
+}
+
+FixedFormat::FixedFormat(double value, int64_t precision) : value_(value), precision_(precision) {
+    if (!std::isfinite(value)) {
+        length_ = std::isnan(value) ? 3 : (value < 0 ? 4 : 3);
+        return;
+    }
+    auto decimal = shortestDecimal(std::fabs(value));
+    digitCount_ = decimalLength(decimal.digits);
+    writeDigits(digits_ + digitCount_, decimal.digits);
+    exponent_ = decimal.exponent + digitCount_ - 1;
+    negative_ = value < 0 && (precision > 0 || exponent_ >= 0);
+    length_ = negative_ + std::max<int64_t>(exponent_, 0) + 1 + (precision > 0 ? precision + 1 : 0);
+}
+
+char FixedFormat::digitAt(int64_t power) const {
+    auto index = exponent_ - power;
+    return index >= 0 && index < digitCount_ ? digits_[index] : '0';
+}
+
+void FixedFormat::write(char *buffer) const {
+    if (!std::isfinite(value_)) {
+        writeShortest(buffer, value_);
+        return;
+    }
+    auto p = buffer;
+    if (negative_) {
+        *p++ = '-';
+    }
+    for (auto power = std::max<int64_t>(exponent_, 0); power >= 0; power--) {
+        *p++ = digitAt(power);
+    }
+    if (precision_ > 0) {
+        *p++ = '.';
+        for (int64_t power = -1; power >= -precision_; power--) {
+            *p++ = digitAt(power);
+        }
+    }
+}
+
+}  // namespace s
@@ -0,0 +1,75 @@
+//
+//  Format.h
+//  Emojicode
+//
+
+#ifndef Format_h
+#define Format_h
+
+#include <cstddef>
+#include <cstdint>
+
+namespace s {
+
+/// The most characters written by writeDecimal().
+const size_t kMaxDecimalLength = 20;
+/// The most characters written by writeShortest().
+const size_t kMaxShortestLength = 24;
+
+/// Returns the number of digits of @c value in decimal base.
+unsigned decimalLength(uint64_t value);
+
+/// Writes the decimal representation of @c value to @c buffer and returns the number of characters written.
+/// Two digits are produced per division by looking them up in a table.
+size_t writeDecimal(char *buffer, int64_t value);
+
+/// A finite, non-negative double as digits × 10^exponent.
+struct Decimal {
+    uint64_t digits;
+    int32_t exponent;
+};
+
+/// Returns the shortest decimal that converts back to the finite and non-negative @c value using the Ryū algorithm.
+/// If there are several, the one closest to @c value is returned.
+Decimal shortestDecimal(double value);
+
+/// Writes the shortest representation of @c value that converts back to @c value to @c buffer and returns the number
+/// of characters written.
+///
+/// Values whose decimal exponent is at least -4 and less than 16 are written positionally with at least one digit
+/// after the decimal separator, e.g. `0.001` or `25.0`. Other values are written in scientific notation with an
+/// exponent of at least two digits, e.g. `1e+16` or `2.5e-07`. Not-a-number and the infinities are written as `nan`,
+/// `inf` and `-inf`.
+size_t writeShortest(char *buffer, double value);
+
+/// Formats a double with a fixed number of digits after the decimal separator.
+///
+/// The digits are those of the shortest representation, which are cut off or padded with zeros. This way, 0.3 with
+/// one digit after the decimal separator is `0.3` although the double nearest to 0.3 is slightly smaller. If the
+/// precision is not positive, only the integral part is written.
+class FixedFormat {
+public:
+    FixedFormat(double value, int64_t precision);
+
+    /// The number of characters written by write().
+    size_t length() const { return length_; }
+    /// Writes length() characters to @c buffer.
+    void write(char *buffer) const;
+
+private:
+    double value_;
+    int64_t precision_;
+    bool negative_ = false;
+    /// The digits of the shortest representation.
+    char digits_[kMaxDecimalLength];
+    int64_t digitCount_ = 0;
+    /// The power of ten of the first digit.
+    int64_t exponent_ = 0;
+    size_t length_;
+
+    char digitAt(int64_t power) const;
+};
+
+}  // namespace s
+
+#endif /* Format_h */
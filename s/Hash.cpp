@@ -0,0 +1,92 @@
+//
+//  Hash.cpp
+//  Emojicode
+//
+//  Implements wyhash (final version 4) by Wang Yi, which was released into the public domain.
+//
+
+#include "Hash.h"
+#include <cstring>
+
+namespace s {
+
+namespace {
+
+__extension__ typedef unsigned __int128 UInt128;
+
+const uint64_t kSecret[4] = {
+    0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull
+};
+
+/// Multiplies @c a and @c b and stores the lower half of the 128-bit product in @c a and the upper half in @c b.
+inline void multiply(uint64_t *a, uint64_t *b) {
+    auto product = static_cast<UInt128>(*a) * *b;
+    *a = static_cast<uint64_t>(product);
+    *b = static_cast<uint64_t>(product >> 64);
+}
+
+inline uint64_t mix(uint64_t a, uint64_t b) {
+    multiply(&a, &b);
+    return a ^ b;
+}
+
+inline uint64_t read8(const unsigned char *p) {
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+    return v;
+}
+
+inline uint64_t read4(const unsigned char *p) {
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+}  // namespace
+
+uint64_t hashBytes(const char *bytes, size_t count, uint64_t seed) {
+    auto p = reinterpret_cast<const unsigned char *>(bytes);
+    seed ^= mix(seed ^ kSecret[0], kSecret[1]);
+    uint64_t a, b;
+    if (count <= 16) {
+        if (count >= 4) {
+            auto middle = (count >> 3) << 2;
+            a = (read4(p) << 32) | read4(p + middle);
+            b = (read4(p + count - 4) << 32) | read4(p + count - 4 - middle);
+        }
+        else if (count > 0) {
+            a = (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[count >> 1]) << 8) | p[count - 1];
+            b = 0;
+        }
+        else {
+            a = b = 0;
+        }
+    }
+    else {
+        auto i = count;
+        if (i > 48) {
+            auto seed1 = seed, seed2 = seed;
+            do {
+                seed = mix(read8(p) ^ kSecret[1], read8(p + 8) ^ seed);
+                seed1 = mix(read8(p + 16) ^ kSecret[2], read8(p + 24) ^ seed1);
+                seed2 = mix(read8(p + 32) ^ kSecret[3], read8(p + 40) ^ seed2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while (i > 16) {
+            seed = mix(read8(p) ^ kSecret[1], read8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = read8(p + i - 16);
+        b = read8(p + i - 8);
+    }
+    a ^= kSecret[1];
+    b ^= seed;
+    multiply(&a, &b);
+    return mix(a ^ kSecret[0] ^ count, b ^ kSecret[1]);
+}
+
+}  // namespace s
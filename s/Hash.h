@@ -0,0 +1,22 @@
+//
+//  Hash.h
+//  Emojicode
+//
+
+#ifndef Hash_h
+#define Hash_h
+
+#include <cstddef>
+#include <cstdint>
+
+namespace s {
+
+/// Returns a 64-bit hash of the @c count bytes at @c bytes using wyhash.
+///
+/// Inputs of up to 16 bytes are hashed with a single 128-bit multiplication. Longer inputs are consumed 48 bytes at a
+/// time by three independent lanes, which the processor can multiply in parallel.
+uint64_t hashBytes(const char *bytes, size_t count, uint64_t seed);
+
+}  // namespace s
+
+#endif /* Hash_h */
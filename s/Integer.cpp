@@ -7,78 +7,92 @@
 //
 
 #include "../runtime/Runtime.h"
+#include "Format.h"
+#include "Parse.h"
 #include "String.h"
 #include <cstdint>
 #include <cstdlib>
-#include <cmath>
+#include <cstring>
 
 using s::String;
 
+runtime::SimpleOptional<runtime::Integer> sStringToIntLength(const char *characters,
+                                                             runtime::Integer length, runtime::Integer base);
+
 extern "C" runtime::Integer sIntAbsolute(runtime::Integer *integer) {
     return std::abs(*integer);
 }
 
 extern "C" s::String* sIntToString(runtime::Integer *nptr, runtime::Integer base) {
-    auto n = *nptr;
-    auto a = std::abs(n);
-    bool negative = n < 0;
-
-    unsigned int d = negative ? 2 : 1;
-    while ((n /= base) != 0) {
-        d++;
+    if (base == 10) {
+        char buffer[s::kMaxDecimalLength];
+        auto length = s::writeDecimal(buffer, *nptr);
+        auto string = String::allocate(length);
+        std::memcpy(string->characters.get(), buffer, length);
+        return string;
     }
 
-    auto string = String::init();
-    string->count = d;
-    string->characters = runtime::allocate<char>(d);
-
-    auto *characters = string->characters.get() + d;
+    // The magnitude is computed unsigned, as the magnitude of the smallest 🔢 cannot be represented as a 🔢.
+    auto n = *nptr;
+    auto a = n < 0 ? 0 - static_cast<uint64_t>(n) : static_cast<uint64_t>(n);
+    auto ubase = static_cast<uint64_t>(base);
+    char buffer[65];
+    auto end = buffer + sizeof(buffer);
+    auto characters = end;
     do {
-        *--characters =  "0123456789abcdefghijklmnopqrstuvxyz"[a % base % 35];
-    } while ((a /= base) > 0);
-
-    if (negative) {
-        characters[-1] = '-';
+        *--characters =  "0123456789abcdefghijklmnopqrstuvxyz"[a % ubase % 35];
+    } while ((a /= ubase) > 0);
+    if (n < 0) {
+        *--characters = '-';
     }
+
+    auto string = String::allocate(end - characters);
+    std::memcpy(string->characters.get(), characters, end - characters);
     return string;
 }
 
 extern "C" s::String* sRealToString(runtime::Real *real, runtime::Integer precision) {
-    double integral;
-    double fractional = std::modf(*real, &integral);
+    s::FixedFormat format(*real, precision);
+    auto string = String::allocate(format.length());
+    format.write(string->characters.get());
+    return string;
+}
 
-    if (precision <= 0) {
-        runtime::Integer i = static_cast<runtime::Integer>(integral);
-        return sIntToString(&i, 10);
-    }
+extern "C" s::String* sRealToShortestString(runtime::Real *real) {
+    char buffer[s::kMaxShortestLength];
+    auto length = s::writeShortest(buffer, *real);
+    auto string = String::allocate(length);
+    std::memcpy(string->characters.get(), buffer, length);
+    return string;
+}
 
-    auto a = std::abs(static_cast<long long>(integral));
-    bool negative = *real < 0;
+extern "C" runtime::Integer sIntWriteDecimal(runtime::Integer *n, runtime::MemoryPointer<char> memory,
+                                             runtime::Integer offset) {
+    return s::writeDecimal(memory.get() + offset, *n);
+}
 
-    unsigned int d = (negative ? 3 : 2) + precision;
-    auto ac = a;
-    while ((ac /= 10) != 0) {
-        d++;
-    }
+extern "C" runtime::Integer sRealWriteShortest(runtime::Real *real, runtime::MemoryPointer<char> memory,
+                                               runtime::Integer offset) {
+    return s::writeShortest(memory.get() + offset, *real);
+}
 
-    auto string = String::init();
-    string->count = d;
-    string->characters = runtime::allocate<char>(d);
+extern "C" void sStringBuilderAppendReal(s::StringBuilder *builder, runtime::Real real) {
+    s::FixedFormat format(real, 6);
+    builder->reserve(format.length());
+    format.write(builder->data.get() + builder->count);
+    builder->count += format.length();
+}
 
-    auto *characters = string->characters.get() + d;
+extern "C" runtime::SimpleOptional<runtime::Integer> sIntParse(runtime::MemoryPointer<char> memory,
+                                                               runtime::Integer offset, runtime::Integer count) {
+    return sStringToIntLength(memory.get() + offset, count, 10);
+}
 
-    auto f = static_cast<long long>(std::abs(std::pow(10, precision) * fractional));
-    for (decltype(precision) i = 0; i < precision; i++) {
-        *--characters = "0123456789"[f % 10];
-        f /= 10;
-    }
-    *--characters = '.';
-    do {
-        *--characters = "0123456789"[a % 10];
-    } while ((a /= 10) > 0);
-    if (negative) {
-        characters[-1] = '-';
+extern "C" runtime::SimpleOptional<runtime::Real> sRealParse(runtime::MemoryPointer<char> memory,
+                                                             runtime::Integer offset, runtime::Integer count) {
+    runtime::Real value;
+    if (!s::parseReal(memory.get() + offset, memory.get() + offset + count, &value)) {
+        return runtime::NoValue;
     }
-    return string;
+    return value;
 }
-
@@ -0,0 +1,67 @@
+//
+//  Intern.cpp
+//  Emojicode
+//
+
+#include "../runtime/Runtime.h"
+#include "String.h"
+#include <cstring>
+#include <mutex>
+#include <unordered_set>
+
+using s::String;
+
+extern "C" runtime::Integer sStringHash(String *string);
+
+namespace {
+
+struct StringHash {
+    size_t operator()(String *string) const { return static_cast<size_t>(sStringHash(string)); }
+};
+
+struct StringEqual {
+    bool operator()(String *a, String *b) const {
+        return a->count == b->count && std::memcmp(a->characters.get(), b->characters.get(), a->count) == 0;
+    }
+};
+
+/// A part of the intern table. Strings are assigned to shards by the high bits of their hash, so that threads
+/// interning different strings rarely contend for the same lock.
+struct Shard {
+    std::mutex mutex;
+    std::unordered_set<String *, StringHash, StringEqual> strings;
+};
+
+const unsigned kShardBits = 6;
+
+/// Interned strings are never released, so the table is never destroyed either. This also keeps it usable by threads
+/// that are still running while static objects are destroyed at exit.
+Shard* shards() {
+    static auto shards = new Shard[1 << kShardBits];
+    return shards;
+}
+
+/// Returns a copy of @c string allocated on the heap. The string passed to sStringIntern() may have been allocated on
+/// the stack of its caller, so the table cannot keep it.
+String* heapCopy(String *string) {
+    auto copy = String::allocate(string->count);
+    std::memcpy(copy->characters.get(), string->characters.get(), string->count);
+    copy->hash = __atomic_load_n(&string->hash, __ATOMIC_RELAXED);
+    return copy;
+}
+
+}  // namespace
+
+extern "C" String* sStringIntern(String *string) {
+    auto hash = static_cast<uint64_t>(sStringHash(string));
+    // The hash has 63 bits, so the highest kShardBits of them select one of the 2^kShardBits shards.
+    auto &shard = shards()[hash >> (63 - kShardBits)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.strings.find(string);
+    if (it == shard.strings.end()) {
+        it = shard.strings.insert(heapCopy(string)).first;
+    }
+    auto canonical = *it;
+    canonical->retain();
+    return canonical;
+}
@@ -0,0 +1,236 @@
+//
+//  Parse.cpp
+//  Emojicode
+//
+
+#include "Parse.h"
+#include "RealTables.h"
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace s {
+
+namespace {
+
+__extension__ typedef unsigned __int128 UInt128;
+
+/// The powers of ten that can be represented exactly by a double.
+const double kExactPowersOf10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+/// The most decimal digits that always fit into 64 bits.
+const int kMaxDigits = 19;
+
+bool isDigit(char c) {
+    return '0' <= c && c <= '9';
+}
+
+/// Loads eight characters so that the first one is in the lowest byte.
+uint64_t loadEight(const char *p) {
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap64(value);
+#endif
+    return value;
+}
+
+/// Returns whether all bytes of @c value are in the range of '0' to '9'.
+bool isEightDigits(uint64_t value) {
+    return (((value + 0x4646464646464646) | (value - 0x3030303030303030)) & 0x8080808080808080) == 0;
+}
+
+/// Converts eight digits loaded by loadEight() to their value by combining pairs of digits, then pairs of those pairs
+/// and so on, in parallel.
+uint32_t parseEightDigits(uint64_t value) {
+    value -= 0x3030303030303030;
+    value = value * 10 + (value >> 8);
+    value = ((value & 0x000000FF000000FF) * (100 + (1000000ULL << 32)) +
+             ((value >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32))) >> 32;
+    return static_cast<uint32_t>(value);
+}
+
+uint64_t makeDouble(uint64_t exponent, uint64_t mantissa, bool negative) {
+    return exponent << 52 | (mantissa & ((uint64_t(1) << 52) - 1)) | (uint64_t(negative) << 63);
+}
+
+/// Computes the double nearest to @c w × 10^q using the Eisel–Lemire algorithm. @c w must not be zero and @c q must
+/// be within the range of kPow10Significands. Returns false if the result is subnormal or infinite or if the
+/// approximation of the power of ten is too coarse to decide how to round.
+bool eiselLemire(uint64_t w, int64_t q, bool negative, double *value) {
+    auto leadingZeros = __builtin_clzll(w);
+    w <<= leadingZeros;
+    // ((217706 × q) >> 16) is floor(log2(10^q)).
+    auto exponent = static_cast<uint64_t>(((217706 * q) >> 16) + 64 + 1023 - leadingZeros);
+
+    auto power = kPow10Significands[q - kPow10MinExponent];
+    auto product = static_cast<UInt128>(w) * power[1];
+    auto high = static_cast<uint64_t>(product >> 64), low = static_cast<uint64_t>(product);
+    if ((high & 0x1FF) == 0x1FF && low + w < w) {
+        // The truncated bits of the power might affect the result, so take the lower 64 bits into account too.
+        auto lowerProduct = static_cast<UInt128>(w) * power[0];
+        auto lowerHigh = static_cast<uint64_t>(lowerProduct >> 64), lowerLow = static_cast<uint64_t>(lowerProduct);
+        auto mergedLow = low + lowerHigh;
+        auto mergedHigh = high + (mergedLow < low);
+        if ((mergedHigh & 0x1FF) == 0x1FF && mergedLow + 1 == 0 && lowerLow + w < w) {
+            return false;
+        }
+        high = mergedHigh;
+        low = mergedLow;
+    }
+
+    // Keep 54 bits, the 53 bits of the mantissa and one for rounding.
+    auto msb = high >> 63;
+    auto mantissa = high >> (msb + 9);
+    exponent -= 1 ^ msb;
+    if (low == 0 && (high & 0x1FF) == 0 && (mantissa & 3) == 1) {
+        // The value might be exactly halfway between two doubles.
+        return false;
+    }
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+    if (mantissa >> 53 > 0) {
+        mantissa >>= 1;
+        exponent++;
+    }
+    if (exponent - 1 >= 0x7FF - 1) {
+        return false;
+    }
+    auto bits = makeDouble(exponent, mantissa, negative);
+    std::memcpy(value, &bits, sizeof(bits));
+    return true;
+}
+
+/// Converts @c w × 10^q, which must not be zero, if possible without falling back to strtod.
+bool convert(uint64_t w, int64_t q, bool negative, bool truncated, double *value) {
+    if (!truncated && w <= uint64_t(1) << 53 && -22 <= q && q <= 22) {
+        // Both w and 10^q are exact doubles, so a single, correctly rounded operation suffices.
+        auto d = static_cast<double>(w);
+        d = q < 0 ? d / kExactPowersOf10[-q] : d * kExactPowersOf10[q];
+        *value = negative ? -d : d;
+        return true;
+    }
+    if (q < kPow10MinExponent) {
+        *value = negative ? -0.0 : 0.0;
+        return true;
+    }
+    if (q > kPow10MaxExponent) {
+        auto bits = makeDouble(0x7FF, 0, negative);
+        std::memcpy(value, &bits, sizeof(bits));
+        return true;
+    }
+    if (!eiselLemire(w, q, negative, value)) {
+        return false;
+    }
+    if (truncated) {
+        // The digits after the first 19 were dropped, so the exact value is between w and w + 1.
+        double upper;
+        return eiselLemire(w + 1, q, negative, &upper) && upper == *value;
+    }
+    return true;
+}
+
+}  // namespace
+
+uint64_t parseDigits(const char *&p, const char *end, uint64_t value) {
+    while (end - p >= 8) {
+        auto eight = loadEight(p);
+        if (!isEightDigits(eight)) {
+            break;
+        }
+        value = value * 100000000 + parseEightDigits(eight);
+        p += 8;
+    }
+    for (; p < end && isDigit(*p); p++) {
+        value = value * 10 + (*p - '0');
+    }
+    return value;
+}
+
+bool parseReal(const char *begin, const char *end, double *value) {
+    auto p = begin;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+
+    auto integralBegin = p;
+    auto w = parseDigits(p, end, 0);
+    auto integralEnd = p;
+    auto fractionBegin = p;
+    if (p < end && *p == '.') {
+        fractionBegin = ++p;
+        w = parseDigits(p, end, w);
+    }
+    auto fractionDigits = p - fractionBegin;
+    auto digits = (integralEnd - integralBegin) + fractionDigits;
+    if (digits == 0) {
+        return false;
+    }
+
+    int64_t exponent = 0;
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool negativeExponent = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            negativeExponent = *p == '-';
+            p++;
+        }
+        if (p == end || !isDigit(*p)) {
+            return false;
+        }
+        for (; p < end && isDigit(*p); p++) {
+            // Larger exponents lead to zero or infinity anyway.
+            if (exponent < 0x10000) {
+                exponent = exponent * 10 + (*p - '0');
+            }
+        }
+        if (negativeExponent) {
+            exponent = -exponent;
+        }
+    }
+    if (p != end) {
+        return false;
+    }
+
+    auto q = exponent - fractionDigits;
+    bool truncated = false;
+    if (digits > kMaxDigits) {
+        // w has wrapped around unless enough of the digits are leading zeros. Otherwise, only the first 19 significant
+        // digits are used.
+        auto significant = integralBegin;
+        for (; significant < p && (*significant == '0' || *significant == '.'); significant++) {
+            if (*significant == '0') {
+                digits--;
+            }
+        }
+        if (digits > kMaxDigits) {
+            truncated = true;
+            w = 0;
+            auto d = significant;
+            for (int taken = 0; taken < kMaxDigits; d++) {
+                if (*d != '.') {
+                    w = w * 10 + (*d - '0');
+                    taken++;
+                }
+            }
+            q = d <= integralEnd ? exponent + (integralEnd - d) : exponent - (d - fractionBegin);
+        }
+    }
+
+    if (w == 0) {
+        *value = negative ? -0.0 : 0.0;
+        return true;
+    }
+    if (convert(w, q, negative, truncated, value)) {
+        return true;
+    }
+    *value = std::strtod(std::string(begin, end).c_str(), nullptr);
+    return true;
+}
+
+}  // namespace s
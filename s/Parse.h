@@ -0,0 +1,28 @@
+//
+//  Parse.h
+//  Emojicode
+//
+
+#ifndef Parse_h
+#define Parse_h
+
+#include <cstdint>
+
+namespace s {
+
+/// Parses the decimal digits starting at @c p and ending at the first non-digit or at @c end, appends them to
+/// @c value and advances @c p past them. Eight digits are parsed at once while possible. The result wraps around if it
+/// does not fit into 64 bits.
+uint64_t parseDigits(const char *&p, const char *end, uint64_t value);
+
+/// Parses the characters from @c begin to @c end as a double, which must match the regular expression
+/// `[+-]?([0-9]+(\.[0-9]*)?|[0-9]*\.[0-9]+)([eE][+-]?[0-9]+)?`. Returns false if they do not match.
+///
+/// The result is the double nearest to the decimal value, with ties rounded to even. It is computed with the
+/// Eisel–Lemire algorithm and only in rare cases, for instance for values exactly halfway between two doubles, with
+/// strtod.
+bool parseReal(const char *begin, const char *end, double *value);
+
+}  // namespace s
+
+#endif /* Parse_h */
@@ -0,0 +1,171 @@
+//
+//  Search.cpp
+//  Emojicode
+//
+
+#include "Search.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace s {
+
+namespace {
+
+const size_t kShortNeedleLength = 32;
+
+/// Computes the maximal suffix of @c needle with respect to the byte order or, if @c reversed is true, the reversed
+/// byte order. Returns the position preceding the suffix, which is -1 if the suffix is the whole needle, and stores
+/// the period of the suffix in @c period.
+ptrdiff_t maximalSuffix(const unsigned char *needle, size_t length, bool reversed, size_t *period) {
+    ptrdiff_t suffix = -1;
+    size_t j = 0, k = 1, p = 1;
+    while (j + k < length) {
+        auto a = needle[j + k];
+        auto b = needle[suffix + k];
+        if (a == b) {
+            if (k == p) {
+                j += p;
+                k = 1;
+            }
+            else {
+                k++;
+            }
+        }
+        else if ((a < b) != reversed) {
+            j += k;
+            k = 1;
+            p = j - suffix;
+        }
+        else {
+            suffix = j;
+            j = suffix + 1;
+            k = p = 1;
+        }
+    }
+    *period = p;
+    return suffix;
+}
+
+}  // namespace
+
+Searcher::Searcher(const char *needle, size_t length)
+        : needle_(reinterpret_cast<const unsigned char *>(needle)), length_(length) {
+    for (size_t i = 0; i < length_; i++) {
+        bytes_.set(needle_[i]);
+    }
+    if (length_ <= kShortNeedleLength) {
+        return;
+    }
+
+    size_t period, reversedPeriod;
+    auto suffix = maximalSuffix(needle_, length_, false, &period);
+    auto reversedSuffix = maximalSuffix(needle_, length_, true, &reversedPeriod);
+    if (reversedSuffix > suffix) {
+        suffix = reversedSuffix;
+        period = reversedPeriod;
+    }
+    critical_ = suffix + 1;
+    periodic_ = std::memcmp(needle_, needle_ + period, critical_) == 0;
+    period_ = periodic_ ? period : std::max(critical_, length_ - critical_) + 1;
+}
+
+const char* Searcher::find(const char *begin, const char *end) const {
+    if (length_ == 0) {
+        return begin;
+    }
+    if (static_cast<size_t>(end - begin) < length_) {
+        return end;
+    }
+    auto ubegin = reinterpret_cast<const unsigned char *>(begin);
+    auto uend = reinterpret_cast<const unsigned char *>(end);
+    const unsigned char *found;
+    if (length_ == 1) {
+        found = static_cast<const unsigned char *>(std::memchr(ubegin, needle_[0], end - begin));
+    }
+    else if (length_ <= kShortNeedleLength) {
+        found = findShort(ubegin, uend);
+    }
+    else {
+        found = findTwoWay(ubegin, uend);
+    }
+    return found == nullptr ? end : reinterpret_cast<const char *>(found);
+}
+
+const unsigned char* Searcher::findShort(const unsigned char *begin, const unsigned char *end) const {
+    auto first = needle_[0];
+    auto last = needle_[length_ - 1];
+    auto lastPosition = end - length_;
+    auto p = begin;
+
+#if defined(__SSE2__)
+    auto firstBytes = _mm_set1_epi8(static_cast<char>(first));
+    auto lastBytes = _mm_set1_epi8(static_cast<char>(last));
+    for (; p + 16 <= lastPosition + 1; p += 16) {
+        auto firstMatches = _mm_cmpeq_epi8(firstBytes, _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+        auto lastMatches = _mm_cmpeq_epi8(lastBytes,
+                                          _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + length_ - 1)));
+        auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(firstMatches, lastMatches)));
+        while (mask != 0) {
+            auto candidate = p + __builtin_ctz(mask);
+            if (std::memcmp(candidate + 1, needle_ + 1, length_ - 2) == 0) {
+                return candidate;
+            }
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    while (p <= lastPosition) {
+        p = static_cast<const unsigned char *>(std::memchr(p, first, lastPosition - p + 1));
+        if (p == nullptr) {
+            return nullptr;
+        }
+        if (p[length_ - 1] == last && std::memcmp(p + 1, needle_ + 1, length_ - 2) == 0) {
+            return p;
+        }
+        p++;
+    }
+    return nullptr;
+}
+
+const unsigned char* Searcher::findTwoWay(const unsigned char *begin, const unsigned char *end) const {
+    auto n = static_cast<size_t>(end - begin);
+    // The number of bytes of the needle’s prefix known to match at the current position, if the needle is periodic.
+    size_t memory = 0;
+    for (size_t j = 0; j + length_ <= n;) {
+        if (!bytes_.test(begin[j + length_ - 1])) {
+            j += length_;
+            memory = 0;
+            continue;
+        }
+
+        auto i = std::max(critical_, memory);
+        while (i < length_ && needle_[i] == begin[j + i]) {
+            i++;
+        }
+        if (i < length_) {
+            j += i - critical_ + 1;
+            memory = 0;
+            continue;
+        }
+
+        i = critical_;
+        while (i > memory && needle_[i - 1] == begin[j + i - 1]) {
+            i--;
+        }
+        if (i <= memory) {
+            return begin + j;
+        }
+        j += period_;
+        if (periodic_) {
+            memory = length_ - period_;
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace s
@@ -0,0 +1,49 @@
+//
+//  Search.h
+//  Emojicode
+//
+
+#ifndef Search_h
+#define Search_h
+
+#include <bitset>
+#include <cstddef>
+
+namespace s {
+
+/// Searches for occurrences of a sequence of bytes, the needle, in other sequences of bytes.
+///
+/// The needle is analysed once when the Searcher is constructed, so a Searcher should be reused when searching for
+/// the same needle repeatedly.
+///
+/// Needles of up to 32 bytes are found by comparing the first and last byte of the needle against 16 positions at
+/// once and only comparing the remaining bytes at positions where both matched. Longer needles are searched with the
+/// Two-Way algorithm, which runs in linear time and constant space.
+class Searcher {
+public:
+    /// Prepares searching for the @c length bytes at @c needle. The bytes are not copied and must outlive this object.
+    Searcher(const char *needle, size_t length);
+
+    /// Returns a pointer to the first occurrence of the needle in [@c begin, @c end) or @c end if there is none.
+    /// An empty needle occurs at @c begin.
+    const char* find(const char *begin, const char *end) const;
+
+private:
+    const unsigned char *needle_;
+    size_t length_;
+
+    /// The critical position of the needle’s factorization used by the Two-Way algorithm.
+    size_t critical_ = 0;
+    /// The period of the needle if periodic_ is true or the shift to apply after a mismatch in the left part.
+    size_t period_ = 0;
+    bool periodic_ = false;
+    /// The bytes occurring in the needle. Windows ending in another byte are skipped entirely.
+    std::bitset<256> bytes_;
+
+    const unsigned char* findShort(const unsigned char *begin, const unsigned char *end) const;
+    const unsigned char* findTwoWay(const unsigned char *begin, const unsigned char *end) const;
+};
+
+}  // namespace s
+
+#endif /* Search_h */
@@ -9,15 +9,22 @@
 #include "../runtime/Runtime.h"
 #include "../runtime/Internal.hpp"
 #include "Data.h"
+#include "Hash.h"
+#include "Parse.h"
+#include "Search.h"
 #include "String.h"
+#include "UTF8.h"
 #include "utf8proc.h"
 #include <algorithm>
 #include <cctype>
 #include <cinttypes>
-#include <cmath>
 #include <cstring>
 #include <iostream>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 using s::String;
 
 std::string String::stdString() {
@@ -29,11 +36,43 @@ String::String(const char *cstring) {
 }
 
 void String::store(const char *cstring) {
+    hash = 0;
     count = strlen(cstring);
     characters = runtime::allocate<char>(count);
     std::memcpy(characters.get(), cstring, count);
 }
 
+String* String::allocate(runtime::Integer count) {
+    auto string = initWithStorage(sizeof(runtime::internal::ControlBlock *) + count);
+    string->count = count;
+    string->characters = runtime::placeUnmanaged<char>(reinterpret_cast<int8_t *>(string + 1));
+    return string;
+}
+
+String* String::initValidating(const char *cstring) {
+    auto count = std::strlen(cstring);
+    auto validation = s::validateUTF8(cstring, count);
+    if (!validation.valid) {
+        return nullptr;
+    }
+    auto string = allocate(count);
+    std::memcpy(string->characters.get(), cstring, count);
+    if (validation.ascii) {
+        string->setASCII();
+    }
+    return string;
+}
+
+extern "C" void ejcMemoryRealloc(int8_t **pointerPtr, runtime::Integer newSize);
+
+void s::StringBuilder::reserve(runtime::Integer bytes) {
+    auto minimumSize = count + bytes;
+    if (minimumSize > size) {
+        size = std::max(size * 2, minimumSize);
+        ejcMemoryRealloc(reinterpret_cast<int8_t **>(&data), size);
+    }
+}
+
 extern "C" void sStringPrint(String *string) {
     std::cout.write(string->characters.get(), string->count) << '\n';
 }
@@ -45,6 +84,7 @@ extern "C" void sStringPrintNoLn(String *string) {
 extern "C" String* sStringReadLine(String *string) {
     std::string str;
     std::getline(std::cin, str);
+    s::repairUTF8(&str);
     string->store(str.c_str());
     return string;
 }
@@ -64,45 +104,115 @@ extern "C" char sStringEndsWith(String *string, String *ending) {
                        ending->count) == 0;
 }
 
-extern "C" String* sStringToLowercase(String *string) {
-    auto newString = String::init();
-    newString->count = string->count;
-    newString->characters = runtime::allocate<char>(string->count);
+extern "C" runtime::Boolean sStringIsASCII(String *string) {
+    if (string->isKnownASCII()) {
+        return true;
+    }
+    if (s::isASCII(string->characters.get(), string->count)) {
+        string->setASCII();
+        return true;
+    }
+    return false;
+}
 
-    size_t doff = 0;
-    for (size_t off = 0; off < string->count;) {
-        utf8proc_int32_t codepoint;
-        auto state = utf8proc_iterate(reinterpret_cast<utf8proc_uint8_t *>(string->characters.get()) + off,
-                                      string->count, &codepoint);
-        if (state < 0) break;
-        doff += utf8proc_encode_char(utf8proc_tolower(codepoint),
-                                     reinterpret_cast<utf8proc_uint8_t *>(newString->characters.get()) + doff);
-        off += state;
+/// Converts the @c count ASCII characters at @c source to uppercase if @c upper is true or to lowercase otherwise and
+/// stores them at @c destination.
+static void mapASCIICase(const char *source, char *destination, size_t count, bool upper) {
+    char first = upper ? 'a' : 'A';
+    size_t i = 0;
+#if defined(__SSE2__)
+    // Moves the letters to convert to the 26 lowest signed values, so that a single comparison finds them.
+    auto offset = _mm_set1_epi8(static_cast<char>(0x80 - first));
+    auto limit = _mm_set1_epi8(-128 + 26);
+    auto caseBit = _mm_set1_epi8(0x20);
+    for (; i + 16 <= count; i += 16) {
+        auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i));
+        auto letters = _mm_cmplt_epi8(_mm_add_epi8(bytes, offset), limit);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(destination + i),
+                         _mm_xor_si128(bytes, _mm_and_si128(letters, caseBit)));
+    }
+#endif
+    for (; i < count; i++) {
+        auto c = source[i];
+        destination[i] = c >= first && c < first + 26 ? c ^ 0x20 : c;
     }
-    return newString;
 }
 
-extern "C" String* sStringToUppercase(String *string) {
-    auto newString = String::init();
-    newString->count = string->count;
-    newString->characters = runtime::allocate<char>(string->count);
+/// Returns a new string in which all characters of @c string have been converted to uppercase if @c upper is true
+/// or to lowercase otherwise.
+///
+/// Runs of ASCII characters are converted 16 at a time. Other characters are converted with utf8proc, which may
+/// change the number of bytes needed to encode them, so the length of the result is determined first unless the
+/// string is known to be ASCII.
+static String* mapCase(String *string, bool upper) {
+    auto begin = string->characters.get();
+    if (string->isKnownASCII()) {
+        auto newString = String::allocate(string->count);
+        mapASCIICase(begin, newString->characters.get(), string->count, upper);
+        newString->setASCII();
+        return newString;
+    }
 
-    size_t doff = 0;
-    for (size_t off = 0; off < string->count;) {
-        utf8proc_int32_t codepoint;
-        auto state = utf8proc_iterate(reinterpret_cast<utf8proc_uint8_t *>(string->characters.get()) + off,
-                                      string->count, &codepoint);
-        if (state < 0) break;
-        doff += utf8proc_encode_char(utf8proc_toupper(codepoint),
-                                     reinterpret_cast<utf8proc_uint8_t *>(newString->characters.get()) + doff);
-        off += state;
+    auto map = upper ? utf8proc_toupper : utf8proc_tolower;
+    auto end = begin + string->count;
+
+    auto decode = [end](const char *p, utf8proc_int32_t *codepoint) -> utf8proc_ssize_t {
+        auto size = utf8proc_iterate(reinterpret_cast<const utf8proc_uint8_t *>(p), end - p, codepoint);
+        if (size < 0) {
+            *codepoint = static_cast<uint8_t>(*p);
+            return 1;
+        }
+        return size;
+    };
+
+    size_t length = 0;
+    bool allASCII = true;
+    for (auto p = begin; p < end;) {
+        auto ascii = s::asciiLength(p, end - p);
+        length += ascii;
+        p += ascii;
+        if (p < end) {
+            allASCII = false;
+            utf8proc_int32_t codepoint;
+            p += decode(p, &codepoint);
+            utf8proc_uint8_t buffer[4];
+            length += utf8proc_encode_char(map(codepoint), buffer);
+        }
+    }
+
+    auto newString = String::allocate(length);
+    auto destination = newString->characters.get();
+    if (allASCII) {
+        mapASCIICase(begin, destination, length, upper);
+        string->setASCII();
+        newString->setASCII();
+        return newString;
+    }
+    for (auto p = begin; p < end;) {
+        auto ascii = s::asciiLength(p, end - p);
+        mapASCIICase(p, destination, ascii, upper);
+        p += ascii;
+        destination += ascii;
+        if (p < end) {
+            utf8proc_int32_t codepoint;
+            p += decode(p, &codepoint);
+            destination += utf8proc_encode_char(map(codepoint), reinterpret_cast<utf8proc_uint8_t *>(destination));
+        }
     }
     return newString;
 }
 
+extern "C" String* sStringToLowercase(String *string) {
+    return mapCase(string, false);
+}
+
+extern "C" String* sStringToUppercase(String *string) {
+    return mapCase(string, true);
+}
+
 extern "C" runtime::SimpleOptional<runtime::Integer> sStringFind(String *string, String* search) {
     auto end = string->characters.get() + string->count;
-    auto pos = std::search(string->characters.get(), end, search->characters.get(), search->characters.get() + search->count);
+    auto pos = s::Searcher(search->characters.get(), search->count).find(string->characters.get(), end);
     if (pos != end) {
         return pos - string->characters.get();
     }
@@ -115,56 +225,90 @@ extern "C" runtime::SimpleOptional<runtime::Integer> sStringFindFromIndex(String
         return runtime::NoValue;
     }
     auto end = string->characters.get() + string->count;
-    auto pos = std::search(string->characters.get() + offset, end, search->characters.get(),
-                           search->characters.get() + search->count);
+    auto pos = s::Searcher(search->characters.get(), search->count).find(string->characters.get() + offset, end);
     if (pos != end) {
         return pos - string->characters.get();
     }
     return runtime::NoValue;
 }
 
+extern "C" void sStringFindAll(String *string, String *search, runtime::Callable<void, runtime::Integer> cb) {
+    if (search->count == 0) {
+        return;
+    }
+    s::Searcher searcher(search->characters.get(), search->count);
+    auto begin = string->characters.get();
+    auto end = begin + string->count;
+    for (auto pos = searcher.find(begin, end); pos != end; pos = searcher.find(pos + search->count, end)) {
+        cb(pos - begin);
+    }
+}
+
 extern "C" void sStringCodepoints(String *string, runtime::Callable<void, runtime::Integer, runtime::Integer> cb) {
+    auto bytes = reinterpret_cast<utf8proc_uint8_t *>(string->characters.get());
     for (size_t off = 0; off < string->count;) {
+        if (bytes[off] < 0x80) {
+            cb(bytes[off], off);
+            off++;
+            continue;
+        }
         utf8proc_int32_t codepoint;
-        auto state = utf8proc_iterate(reinterpret_cast<utf8proc_uint8_t *>(string->characters.get()) + off,
-                                      string->count, &codepoint);
+        auto state = utf8proc_iterate(bytes + off, string->count - off, &codepoint);
         if (state < 0) break;
         cb(codepoint, off);
         off += state;
     }
 }
 
-extern "C" s::String* sStringTrim(String *string) {
-    size_t begin = 0;
+/// Whether @c codepoint is removed from the start and end of a string by sStringTrim().
+static bool isTrimmed(utf8proc_int32_t codepoint) {
+    if (codepoint < 0x80) {
+        return codepoint == ' ' || codepoint == '\f';
+    }
+    return utf8proc_get_property(codepoint)->bidi_class == UTF8PROC_BIDI_CLASS_WS;
+}
 
-    for (; begin < string->count;) {
-        utf8proc_int32_t codepoint;
-        auto state = utf8proc_iterate(reinterpret_cast<utf8proc_uint8_t *>(string->characters.get()) + begin,
-                                      string->count, &codepoint);
-        if (state < 0) break;
-        if (utf8proc_get_property(codepoint)->bidi_class != UTF8PROC_BIDI_CLASS_WS) break;
-        begin += state;
+extern "C" s::String* sStringTrim(String *string) {
+    auto bytes = reinterpret_cast<utf8proc_uint8_t *>(string->characters.get());
+    size_t begin = 0, end = string->count;
+
+    while (begin < end) {
+        utf8proc_int32_t codepoint = bytes[begin];
+        utf8proc_ssize_t size = 1;
+        if (codepoint >= 0x80) {
+            size = utf8proc_iterate(bytes + begin, end - begin, &codepoint);
+            if (size < 0) break;
+        }
+        if (!isTrimmed(codepoint)) break;
+        begin += size;
     }
 
-    size_t end = begin - 1;
-    for (size_t i = begin; i < string->count;) {
-        utf8proc_int32_t codepoint;
-        auto state = utf8proc_iterate(reinterpret_cast<utf8proc_uint8_t *>(string->characters.get()) + i,
-                                      string->count, &codepoint);
-        if (state < 0) break;
-        if (utf8proc_get_property(codepoint)->bidi_class != UTF8PROC_BIDI_CLASS_WS) {
-            end = i;
+    // Scans backwards from the end, so that only the trailing characters are decoded.
+    while (end > begin) {
+        auto start = end - 1;
+        while (start > begin && (bytes[start] & 0xC0) == 0x80) {
+            start--;
         }
-        i += state;
+        utf8proc_int32_t codepoint = bytes[start];
+        if (codepoint >= 0x80 && utf8proc_iterate(bytes + start, end - start, &codepoint) < 0) break;
+        if (!isTrimmed(codepoint)) break;
+        end = start;
     }
 
-    auto newString = String::init();
-    newString->count = end - begin + 1;
-    newString->characters = runtime::allocate<char>(string->count);
+    auto newString = String::allocate(end - begin);
     std::memcpy(newString->characters.get(), string->characters.get() + begin, newString->count);
+    if (string->isKnownASCII()) {
+        newString->setASCII();
+    }
     return newString;
 }
 
+/// Returns the state to pass to utf8proc_grapheme_break_stateful() when segmenting graphemes starting with @c first.
+/// Starting with a state of 0 would not recognize an emoji at the start as such and break emoji ZWJ sequences.
+static utf8proc_int32_t graphemeBreakState(utf8proc_int32_t first) {
+    return utf8proc_get_property(first)->boundclass;
+}
+
 extern "C" void sStringGraphemes(String *string, runtime::Callable<void, s::String*> cb) {
     auto bytes = reinterpret_cast<utf8proc_uint8_t *>(string->characters.get());
     utf8proc_int32_t state = 0;
@@ -176,15 +320,14 @@ extern "C" void sStringGraphemes(String *string, runtime::Callable<void, s::Stri
 
     size_t lastCut = 0;
     size_t off = utf8proc_iterate(bytes, string->count, &prev);
+    state = graphemeBreakState(prev);
 
     while (off < string->count) {
         utf8proc_int32_t cp;
         auto c = utf8proc_iterate(bytes + off, string->count, &cp);
 
         if (utf8proc_grapheme_break_stateful(prev, cp, &state)) {
-            auto newString = String::init();
-            newString->count = off - lastCut;
-            newString->characters = runtime::allocate<char>(newString->count);
+            auto newString = String::allocate(off - lastCut);
             std::memcpy(newString->characters.get(), string->characters.get() + lastCut, newString->count);
             lastCut = off;
             cb(newString);
@@ -194,9 +337,7 @@ extern "C" void sStringGraphemes(String *string, runtime::Callable<void, s::Stri
         off += c;
     }
 
-    auto newString = String::init();
-    newString->count = off - lastCut;
-    newString->characters = runtime::allocate<char>(newString->count);
+    auto newString = String::allocate(off - lastCut);
     std::memcpy(newString->characters.get(), string->characters.get() + lastCut, newString->count);
     lastCut = off;
     cb(newString);
@@ -208,12 +349,10 @@ extern "C" s::String* sStringGraphemeSubstring(String *string, runtime::Integer
     utf8proc_int32_t state = 0;
     utf8proc_int32_t prev, cp;
     size_t beginCut = 0, off = utf8proc_iterate(bytes, string->count, &prev);
+    state = graphemeBreakState(prev);
 
     if (length == 0) {
-        auto newString = String::init();
-        newString->count = 0;
-        newString->characters = runtime::allocate<char>(0);
-        return newString;
+        return String::allocate(0);
     }
 
     while (off < string->count && from > 0) {
@@ -238,155 +377,101 @@ extern "C" s::String* sStringGraphemeSubstring(String *string, runtime::Integer
         off += c;
     }
 
-    auto newString = String::init();
-    newString->count = off - beginCut;
-    newString->characters = runtime::allocate<char>(newString->count);
+    auto newString = String::allocate(off - beginCut);
     std::memcpy(newString->characters.get(), string->characters.get() + beginCut, newString->count);
     return newString;
 }
 
-runtime::SimpleOptional<runtime::Integer> sStringToIntLength(const char *characters,
-                                                             runtime::Integer length, runtime::Integer base) {
-    if (length == 0) {
-        return runtime::NoValue;
+extern "C" runtime::Integer sStringGraphemeEnd(String *string, runtime::Integer offset) {
+    if (offset >= string->count) {
+        return string->count;
     }
-    runtime::Integer x = 0;
-    for (decltype(length) i = 0; i < length; i++) {
-        if (i == 0 && (characters[i] == '-' || characters[i] == '+')) {
-            if (length < 2) {
-                return runtime::NoValue;
-            }
-            continue;
-        }
 
-        auto b = base;
-        if ('0' <= characters[i] && characters[i] <= '9') {
-            b = characters[i] - '0';
-        }
-        else if ('A' <= characters[i] && characters[i] <= 'Z') {
-            b = characters[i] - 'A' + 10;
-        }
-        else if ('a' <= characters[i] && characters[i] <= 'z') {
-            b = characters[i] - 'a' + 10;
-        }
+    auto bytes = reinterpret_cast<utf8proc_uint8_t *>(string->characters.get());
+    utf8proc_int32_t prev, cp;
+    auto off = offset + utf8proc_iterate(bytes + offset, string->count - offset, &prev);
+    auto state = graphemeBreakState(prev);
 
-        if (b >= base) {
-            return runtime::NoValue;
+    while (off < string->count) {
+        auto c = utf8proc_iterate(bytes + off, string->count - off, &cp);
+        if (utf8proc_grapheme_break_stateful(prev, cp, &state)) {
+            break;
         }
-
-        x *= base;
-        x += b;
-    }
-
-    if (characters[0] == '-') {
-        x *= -1;
+        prev = cp;
+        off += c;
     }
-    return x;
+    return off;
 }
 
-extern "C" runtime::SimpleOptional<runtime::Integer> sStringToInt(String *string, runtime::Integer base) {
-    return sStringToIntLength(string->characters.get(), string->count, base);
-}
-
-extern "C" runtime::SimpleOptional<runtime::Real> sStringToReal(String *string) {
-    if (string->count == 0) {
+runtime::SimpleOptional<runtime::Integer> sStringToIntLength(const char *characters,
+                                                             runtime::Integer length, runtime::Integer base) {
+    if (length == 0) {
         return runtime::NoValue;
     }
-
-    runtime::Real d = 0.0;
-    bool sign = true;
-    bool foundSeparator = false;
-    bool foundDigit = false;
-    size_t decimalPlace = 0;
-    decltype(string->count) i = 0;
-
-    if (string->characters[0] == '-') {
-        sign = false;
-        i++;
-    }
-    else if (string->characters[0] == '+') {
+    auto negative = characters[0] == '-';
+    decltype(length) i = 0;
+    if (negative || characters[0] == '+') {
+        if (length < 2) {
+            return runtime::NoValue;
+        }
         i++;
     }
 
-    for (; i < string->count; i++) {
-        if (string->characters[i] == '.') {
-            if (foundSeparator) {
-                return runtime::NoValue;
-            }
-            foundSeparator = true;
-            continue;
+    uint64_t x = 0;
+    if (base == 10) {
+        auto p = characters + i;
+        x = s::parseDigits(p, characters + length, 0);
+        if (p != characters + length) {
+            return runtime::NoValue;
         }
-        if (string->characters[i] == 'e' || string->characters[i] == 'E') {
-            auto exponent = sStringToIntLength(string->characters.get() + i + 1, string->count - i - 1, 10);
-            if (exponent == runtime::NoValue) {
-                return runtime::NoValue;
+    }
+    else {
+        for (; i < length; i++) {
+            auto b = base;
+            if ('0' <= characters[i] && characters[i] <= '9') {
+                b = characters[i] - '0';
             }
-            d *= std::pow(10, *exponent);
-            break;
-        }
-        if ('0' <= string->characters[i] && string->characters[i] <= '9') {
-            d *= 10;
-            d += string->characters[i] - '0';
-            if (foundSeparator) {
-                decimalPlace++;
+            else if ('A' <= characters[i] && characters[i] <= 'Z') {
+                b = characters[i] - 'A' + 10;
             }
-            foundDigit = true;
-        }
-        else {
-            return runtime::NoValue;
+            else if ('a' <= characters[i] && characters[i] <= 'z') {
+                b = characters[i] - 'a' + 10;
+            }
+
+            if (b >= base) {
+                return runtime::NoValue;
+            }
+
+            x = x * base + b;
         }
     }
 
-    if (!foundDigit) {
-        return runtime::NoValue;
+    if (negative) {
+        x = 0 - x;
     }
+    return static_cast<runtime::Integer>(x);
+}
 
-    d /= std::pow(10, decimalPlace);
+extern "C" runtime::SimpleOptional<runtime::Integer> sStringToInt(String *string, runtime::Integer base) {
+    return sStringToIntLength(string->characters.get(), string->count, base);
+}
 
-    if (!sign) {
-        d *= -1;
+extern "C" runtime::SimpleOptional<runtime::Real> sStringToReal(String *string) {
+    runtime::Real value;
+    if (!s::parseReal(string->characters.get(), string->characters.get() + string->count, &value)) {
+        return runtime::NoValue;
     }
-    return d;
+    return value;
 }
 
 extern "C" runtime::Integer sStringHash(String *string) {
-    auto len = string->count;
-    const unsigned int m = 0x5bd1e995;
-    const int r = 24;
-
-    unsigned int h = runtime::internal::seed ^ len;
-
-    const unsigned char * data = reinterpret_cast<const unsigned char *>(string->characters.get());
-
-    while(len >= 4) {
-        unsigned int k;
-
-        k  = data[0];
-        k |= data[1] << 8;
-        k |= data[2] << 16;
-        k |= data[3] << 24;
-
-        k *= m;
-        k ^= k >> r;
-        k *= m;
-
-        h *= m;
-        h ^= k;
-
-        data += 4;
-        len -= 4;
+    auto cached = __atomic_load_n(&string->hash, __ATOMIC_RELAXED) & ~String::kASCII;
+    if (cached != 0) {
+        return cached;
     }
-
-    switch(len) {
-        case 3: h ^= data[2] << 16;
-        case 2: h ^= data[1] << 8;
-        case 1: h ^= data[0];
-                h *= m;
-    }
-
-    h ^= h >> 13;
-    h *= m;
-    h ^= h >> 15;
-
-    return h;
+    auto hash = static_cast<runtime::Integer>(s::hashBytes(string->characters.get(), string->count,
+                                                           static_cast<uint64_t>(runtime::internal::seed)) >> 1);
+    // Or-ed in, so that a concurrent setASCII() is not lost.
+    __atomic_fetch_or(&string->hash, hash, __ATOMIC_RELAXED);
+    return hash;
 }
@@ -26,13 +26,48 @@ public:
     /// @warning Do not use this method to modify an existing string, i.e. one that has a value already.
     void store(const char *cstring);
 
+    /// Creates a string of @c count bytes, which are uninitialized.
+    ///
+    /// The bytes are stored in the same allocation as the string object, which saves allocating and reference
+    /// counting a separate memory area. This matters most for the many short strings created by splitting text.
+    static String* allocate(runtime::Integer count);
+
+    /// Creates a string from the null-terminated @c cstring if it is valid UTF-8, and returns @c nullptr otherwise.
+    ///
+    /// Use this for all text that enters the program from outside, such as environment variables, arguments or paths.
+    static String* initValidating(const char *cstring);
+
+    /// Set in @c hash if the string is known to consist of ASCII characters only. The hash itself has 63 bits and
+    /// never has this bit set.
+    static constexpr runtime::Integer kASCII = INT64_MIN;
+
+    /// Returns true if the string has been found to consist of ASCII characters only. If this returns false, the
+    /// string may still be ASCII but has not been checked yet.
+    bool isKnownASCII() const { return (__atomic_load_n(&hash, __ATOMIC_RELAXED) & kASCII) != 0; }
+    /// Records that the string consists of ASCII characters only.
+    void setASCII() { __atomic_fetch_or(&hash, kASCII, __ATOMIC_RELAXED); }
+
     runtime::MemoryPointer<char> characters;
     runtime::Integer count;
+    /// The hash returned by sStringHash(), or 0 if it has not been computed yet, combined with kASCII. Strings are
+    /// immutable, so the hash is usually computed at most once per string. Only a string whose hash is 0 hashes again.
+    runtime::Integer hash = 0;
 
     std::string stdString();
     int compare(String *other);
 };
 
+/// The layout of a 🔠.
+class StringBuilder : public runtime::Object<StringBuilder> {
+public:
+    /// Ensures that at least @c bytes can be appended to @c data, growing it like 🍜 does.
+    void reserve(runtime::Integer bytes);
+
+    runtime::MemoryPointer<char> data;
+    runtime::Integer count;
+    runtime::Integer size;
+};
+
 }  // namespace s
 
 SET_INFO_FOR(s::String, s, 1f521)
@@ -18,8 +18,11 @@ extern "C" runtime::Integer sSystemUnixTimestamp(runtime::ClassInfo*) {
 
 extern "C" runtime::SimpleOptional<s::String*> sSystemGetEnv(runtime::ClassInfo*, s::String *name) {
     auto var = std::getenv(name->stdString().c_str());
-    if (var != nullptr) {
-        return s::String::init(var);
+    if (var == nullptr) {
+        return runtime::NoValue;
+    }
+    if (auto string = s::String::initValidating(var)) {
+        return string;
     }
     return runtime::NoValue;
 }
@@ -32,7 +35,10 @@ extern "C" runtime::SimpleOptional<s::String*> sSystemArg(runtime::ClassInfo*, r
     if (i >= runtime::internal::argc) {
         return runtime::NoValue;
     }
-    return s::String::init(runtime::internal::argv[i]);
+    if (auto string = s::String::initValidating(runtime::internal::argv[i])) {
+        return string;
+    }
+    return runtime::NoValue;
 }
 
 extern "C" void sSystemSystem(runtime::ClassInfo*, s::String *string) {
@@ -0,0 +1,344 @@
+//
+//  UTF8.cpp
+//  Emojicode
+//
+
+#include "UTF8.h"
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define EJC_UTF8_SIMD
+#include <immintrin.h>
+#endif
+
+namespace s {
+
+namespace {
+
+const uint64_t kHighBits = 0x8080808080808080;
+
+/// Returns the length of the well-formed sequence starting at @c p or 0 if there is none.
+size_t sequenceLength(const uint8_t *p, const uint8_t *end) {
+    auto lead = p[0];
+    if (lead < 0x80) {
+        return 1;
+    }
+    size_t length;
+    uint8_t min = 0x80, max = 0xBF;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        length = 2;
+    }
+    else if (lead >= 0xE0 && lead <= 0xEF) {
+        length = 3;
+        if (lead == 0xE0) min = 0xA0;
+        else if (lead == 0xED) max = 0x9F;
+    }
+    else if (lead >= 0xF0 && lead <= 0xF4) {
+        length = 4;
+        if (lead == 0xF0) min = 0x90;
+        else if (lead == 0xF4) max = 0x8F;
+    }
+    else {
+        return 0;
+    }
+    if (static_cast<size_t>(end - p) < length || p[1] < min || p[1] > max) {
+        return 0;
+    }
+    for (size_t i = 2; i < length; i++) {
+        if ((p[i] & 0xC0) != 0x80) {
+            return 0;
+        }
+    }
+    return length;
+}
+
+UTF8Validation validateScalar(const uint8_t *p, size_t count) {
+    auto end = p + count;
+    bool ascii = true;
+    while (p < end) {
+        if (end - p >= 8) {
+            uint64_t word;
+            std::memcpy(&word, p, sizeof(word));
+            if ((word & kHighBits) == 0) {
+                p += 8;
+                continue;
+            }
+        }
+        if (*p < 0x80) {
+            p++;
+            continue;
+        }
+        ascii = false;
+        auto length = sequenceLength(p, end);
+        if (length == 0) {
+            return { false, false };
+        }
+        p += length;
+    }
+    return { true, ascii };
+}
+
+#ifdef EJC_UTF8_SIMD
+
+// The vectorised validators look up the high and low nibble of every byte and the high nibble of its successor in
+// three tables and AND the results. Each bit of the result stands for one kind of error that a pair of bytes can
+// exhibit. Bytes that must be the second or third continuation byte of a sequence are detected separately and must
+// carry exactly the bit TWO_CONTS. See Keiser and Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte".
+
+const uint8_t kTooShort = 1 << 0;
+const uint8_t kTooLong = 1 << 1;
+const uint8_t kOverlong3 = 1 << 2;
+const uint8_t kTooLarge = 1 << 3;
+const uint8_t kSurrogate = 1 << 4;
+const uint8_t kOverlong2 = 1 << 5;
+const uint8_t kTooLarge1000 = 1 << 6;
+const uint8_t kOverlong4 = 1 << 6;
+const uint8_t kTwoConts = 1 << 7;
+const uint8_t kCarry = kTooShort | kTooLong | kTwoConts;
+
+alignas(16) const uint8_t kByte1High[16] = {
+    kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong,
+    kTwoConts, kTwoConts, kTwoConts, kTwoConts,
+    kTooShort | kOverlong2,
+    kTooShort,
+    kTooShort | kOverlong3 | kSurrogate,
+    kTooShort | kTooLarge | kTooLarge1000 | kOverlong4,
+};
+
+alignas(16) const uint8_t kByte1Low[16] = {
+    kCarry | kOverlong3 | kOverlong2 | kOverlong4,
+    kCarry | kOverlong2,
+    kCarry,
+    kCarry,
+    kCarry | kTooLarge,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+};
+
+alignas(16) const uint8_t kByte2High[16] = {
+    kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort,
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 | kOverlong4,
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+    kTooShort, kTooShort, kTooShort, kTooShort,
+};
+
+/// Bytes greater than these values at the end of a block start a sequence that continues in the next block.
+alignas(32) const uint8_t kIncompleteLimits[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF,
+};
+
+/// The state carried from one block to the next by validateSSE().
+struct SSEValidationState {
+    __m128i error;
+    __m128i previous;
+    __m128i previousIncomplete;
+    bool ascii = true;
+};
+
+/// The state carried from one block to the next by validateAVX2().
+struct AVX2ValidationState {
+    __m256i error;
+    __m256i previous;
+    __m256i previousIncomplete;
+    bool ascii = true;
+};
+
+__attribute__((target("sse4.1")))
+void checkBlock(__m128i input, SSEValidationState *state) {
+    if (_mm_movemask_epi8(input) == 0) {
+        state->error = _mm_or_si128(state->error, state->previousIncomplete);
+        state->previousIncomplete = _mm_setzero_si128();
+        state->previous = input;
+        return;
+    }
+    state->ascii = false;
+    auto nibble = _mm_set1_epi8(0x0F);
+    auto prev1 = _mm_alignr_epi8(input, state->previous, 15);
+    auto byte1High = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i *>(kByte1High)),
+                                      _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+    auto byte1Low = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i *>(kByte1Low)),
+                                     _mm_and_si128(prev1, nibble));
+    auto byte2High = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i *>(kByte2High)),
+                                      _mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+    auto special = _mm_and_si128(_mm_and_si128(byte1High, byte1Low), byte2High);
+
+    auto third = _mm_subs_epu8(_mm_alignr_epi8(input, state->previous, 14), _mm_set1_epi8(0xE0 - 0x80));
+    auto fourth = _mm_subs_epu8(_mm_alignr_epi8(input, state->previous, 13), _mm_set1_epi8(0xF0 - 0x80));
+    auto mustBeContinuation = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(static_cast<char>(0x80)));
+
+    state->error = _mm_or_si128(state->error, _mm_xor_si128(mustBeContinuation, special));
+    state->previousIncomplete = _mm_subs_epu8(input,
+                                              _mm_loadu_si128(reinterpret_cast<const __m128i *>(kIncompleteLimits + 16)));
+    state->previous = input;
+}
+
+__attribute__((target("sse4.1")))
+UTF8Validation validateSSE(const uint8_t *p, size_t count) {
+    SSEValidationState state;
+    state.error = state.previous = state.previousIncomplete = _mm_setzero_si128();
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        checkBlock(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p + i)), &state);
+    }
+    // The zero padding of the last block makes sequences truncated by the end of the bytes fail as too short.
+    alignas(16) uint8_t last[16] = {};
+    if (i < count) {
+        std::memcpy(last, p + i, count - i);
+    }
+    checkBlock(_mm_load_si128(reinterpret_cast<const __m128i *>(last)), &state);
+
+    auto valid = _mm_testz_si128(state.error, state.error) != 0;
+    return { valid, valid && state.ascii };
+}
+
+__attribute__((target("avx2")))
+void checkBlock(__m256i input, AVX2ValidationState *state) {
+    if (_mm256_movemask_epi8(input) == 0) {
+        state->error = _mm256_or_si256(state->error, state->previousIncomplete);
+        state->previousIncomplete = _mm256_setzero_si256();
+        state->previous = input;
+        return;
+    }
+    state->ascii = false;
+    auto nibble = _mm256_set1_epi8(0x0F);
+    // The upper half of previous followed by the lower half of input, so that bytes can be shifted across lanes.
+    auto carried = _mm256_permute2x128_si256(state->previous, input, 0x21);
+    auto prev1 = _mm256_alignr_epi8(input, carried, 15);
+    auto byte1High = _mm256_shuffle_epi8(
+            _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(kByte1High))),
+            _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble));
+    auto byte1Low = _mm256_shuffle_epi8(
+            _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(kByte1Low))),
+            _mm256_and_si256(prev1, nibble));
+    auto byte2High = _mm256_shuffle_epi8(
+            _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i *>(kByte2High))),
+            _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble));
+    auto special = _mm256_and_si256(_mm256_and_si256(byte1High, byte1Low), byte2High);
+
+    auto third = _mm256_subs_epu8(_mm256_alignr_epi8(input, carried, 14), _mm256_set1_epi8(0xE0 - 0x80));
+    auto fourth = _mm256_subs_epu8(_mm256_alignr_epi8(input, carried, 13), _mm256_set1_epi8(0xF0 - 0x80));
+    auto mustBeContinuation = _mm256_and_si256(_mm256_or_si256(third, fourth),
+                                               _mm256_set1_epi8(static_cast<char>(0x80)));
+
+    state->error = _mm256_or_si256(state->error, _mm256_xor_si256(mustBeContinuation, special));
+    state->previousIncomplete = _mm256_subs_epu8(input,
+                                                 _mm256_load_si256(reinterpret_cast<const __m256i *>(kIncompleteLimits)));
+    state->previous = input;
+}
+
+__attribute__((target("avx2")))
+UTF8Validation validateAVX2(const uint8_t *p, size_t count) {
+    AVX2ValidationState state;
+    state.error = state.previous = state.previousIncomplete = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        checkBlock(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + i)), &state);
+    }
+    alignas(32) uint8_t last[32] = {};
+    if (i < count) {
+        std::memcpy(last, p + i, count - i);
+    }
+    checkBlock(_mm256_load_si256(reinterpret_cast<const __m256i *>(last)), &state);
+
+    auto valid = _mm256_testz_si256(state.error, state.error) != 0;
+    return { valid, valid && state.ascii };
+}
+
+#endif
+
+using Validator = UTF8Validation (*)(const uint8_t *, size_t);
+
+Validator selectValidator() {
+#ifdef EJC_UTF8_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return validateAVX2;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return validateSSE;
+    }
+#endif
+    return validateScalar;
+}
+
+}  // namespace
+
+UTF8Validation validateUTF8(const char *bytes, size_t count) {
+    static const Validator validator = selectValidator();
+    return validator(reinterpret_cast<const uint8_t *>(bytes), count);
+}
+
+bool isASCII(const char *bytes, size_t count) {
+    uint64_t bits = 0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+        bits |= word;
+    }
+    for (; i < count; i++) {
+        bits |= static_cast<uint8_t>(bytes[i]);
+    }
+    return (bits & kHighBits) == 0;
+}
+
+size_t asciiLength(const char *bytes, size_t count) {
+    size_t i = 0;
+#ifdef EJC_UTF8_SIMD
+    for (; i + 16 <= count; i += 16) {
+        auto mask = _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes + i)));
+        if (mask != 0) {
+            return i + __builtin_ctz(static_cast<unsigned>(mask));
+        }
+    }
+#endif
+    for (; i + 8 <= count; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+        if ((word & kHighBits) != 0) {
+            break;
+        }
+    }
+    while (i < count && static_cast<uint8_t>(bytes[i]) < 0x80) {
+        i++;
+    }
+    return i;
+}
+
+void repairUTF8(std::string *string) {
+    auto begin = reinterpret_cast<const uint8_t *>(string->data());
+    if (validateUTF8(string->data(), string->size()).valid) {
+        return;
+    }
+    auto end = begin + string->size();
+    std::string repaired;
+    repaired.reserve(string->size() + 8);
+    for (auto p = begin; p < end;) {
+        if (auto length = sequenceLength(p, end)) {
+            repaired.append(reinterpret_cast<const char *>(p), length);
+            p += length;
+        }
+        else {
+            repaired.append("\xEF\xBF\xBD");
+            p++;
+        }
+    }
+    *string = std::move(repaired);
+}
+
+}  // namespace s
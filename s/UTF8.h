@@ -0,0 +1,41 @@
+//
+//  UTF8.h
+//  Emojicode
+//
+
+#ifndef UTF8_h
+#define UTF8_h
+
+#include <cstddef>
+#include <string>
+
+namespace s {
+
+/// The result of validating a sequence of bytes with validateUTF8().
+struct UTF8Validation {
+    /// Whether the bytes are well-formed UTF-8, i.e. contain no overlong encodings, surrogates, code points above
+    /// U+10FFFF or truncated sequences.
+    bool valid;
+    /// Whether all bytes are ASCII characters. If this is true, valid is true as well.
+    bool ascii;
+};
+
+/// Validates that the @c count bytes at @c bytes are well-formed UTF-8.
+///
+/// On x86-64 processors supporting AVX2 or SSE4.1 the bytes are checked in blocks of 32 or 16 bytes respectively.
+/// The implementation is selected once at run time. Other processors use a scalar implementation that skips runs
+/// of ASCII characters eight bytes at a time.
+UTF8Validation validateUTF8(const char *bytes, size_t count);
+
+/// Returns true if all @c count bytes at @c bytes are ASCII characters.
+bool isASCII(const char *bytes, size_t count);
+
+/// Returns the number of ASCII characters at the beginning of the @c count bytes at @c bytes.
+size_t asciiLength(const char *bytes, size_t count);
+
+/// Replaces every byte in @c string that does not begin a well-formed sequence with U+FFFD REPLACEMENT CHARACTER.
+void repairUTF8(std::string *string);
+
+}  // namespace s
+
+#endif /* UTF8_h */
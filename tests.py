@@ -23,6 +23,8 @@ compilation_tests = [
     "assignmentMethod",
     "assignmentByCall",
     "repeatWhile",
+    "forIn",
+    "dictionaryLiteral",
     "conditionalProduce",
     "stringConcat",
     "babyBottleInitializer",
@@ -63,6 +65,7 @@ compilation_tests = [
     "generics",
     "genericsValueType",
     "genericProtocol",
+    "subclassProtocol",
     "genericProtocolValueType",
     "genericTypeMethod",
     "genericLocalAsArgToGeneric",
@@ -100,6 +103,7 @@ compilation_tests = [
     "rcOnlyReference",
     "rcIvarArgMut",
     "rcEscaping",
+    "memoryResize",
     "classEscapingParamOverride",
     "references",
     "identifierTest",
@@ -128,6 +132,14 @@ library_tests = [
     "listTest",
     "enumerator",
     "dictionaryTest",
+    "setTest",
+    "bitsetTest",
+    "sliceTest",
+    "dequeTest",
+    "heapTest",
+    "treeMapTest",
+    "persistentMapTest",
+    "sequenceTest",
     "jsonTest",
     "fileTest"
 ]